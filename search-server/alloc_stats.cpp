@@ -0,0 +1,154 @@
+#include "alloc_stats.h"
+
+#ifdef SEARCH_SERVER_ALLOC_STATS
+#include <new>
+#include <mutex>
+#include <cstdlib>
+
+using namespace std;
+
+namespace {
+const size_t HOT_PATH_COUNT = 4;
+
+thread_local AllocationStats thread_stats;
+thread_local AllocationStats last_call_stats[HOT_PATH_COUNT];
+
+mutex aggregate_mutex;
+AllocationStats aggregate_stats[HOT_PATH_COUNT];
+
+void* CountedAllocate(size_t size, size_t alignment) {
+    ++thread_stats.allocations;
+    thread_stats.bytes += size;
+    void* ptr = nullptr;
+    if (alignment <= alignof(max_align_t)) {
+        ptr = malloc(size == 0 ? 1 : size);
+    } else {
+        ptr = aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    return ptr;
+}
+
+void* CountedAllocateOrThrow(size_t size, size_t alignment) {
+    void* ptr = CountedAllocate(size, alignment);
+    if (ptr == nullptr) {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+AllocationStats Difference(const AllocationStats& end, const AllocationStats& start) {
+    return {1, end.allocations - start.allocations, end.bytes - start.bytes,
+            end.string_copies - start.string_copies};
+}
+}
+
+void* operator new(size_t size) {
+    return CountedAllocateOrThrow(size, alignof(max_align_t));
+}
+void* operator new[](size_t size) {
+    return CountedAllocateOrThrow(size, alignof(max_align_t));
+}
+void* operator new(size_t size, align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new[](size_t size, align_val_t alignment) {
+    return CountedAllocateOrThrow(size, static_cast<size_t>(alignment));
+}
+void* operator new(size_t size, const nothrow_t&) noexcept {
+    return CountedAllocate(size, alignof(max_align_t));
+}
+void* operator new[](size_t size, const nothrow_t&) noexcept {
+    return CountedAllocate(size, alignof(max_align_t));
+}
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+void operator delete(void* ptr, align_val_t) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr, align_val_t) noexcept {
+    free(ptr);
+}
+void operator delete(void* ptr, size_t, align_val_t) noexcept {
+    free(ptr);
+}
+void operator delete[](void* ptr, size_t, align_val_t) noexcept {
+    free(ptr);
+}
+
+bool IsAllocationStatsEnabled() {
+    return true;
+}
+
+AllocationStats GetThreadAllocationStats() {
+    return thread_stats;
+}
+
+AllocationStats GetLastCallAllocationStats(HotPath path) {
+    return last_call_stats[static_cast<size_t>(path)];
+}
+
+AllocationStats GetAggregateAllocationStats(HotPath path) {
+    lock_guard guard(aggregate_mutex);
+    return aggregate_stats[static_cast<size_t>(path)];
+}
+
+void ResetAllocationStats() {
+    lock_guard guard(aggregate_mutex);
+    for (auto& stats : aggregate_stats) {
+        stats = {};
+    }
+}
+
+void CountStringCopy() {
+    ++thread_stats.string_copies;
+}
+
+AllocationProbe::AllocationProbe(HotPath path)
+    : path_(path)
+    , start_(thread_stats)
+{
+}
+
+AllocationProbe::~AllocationProbe() {
+    const AllocationStats call = Difference(thread_stats, start_);
+    last_call_stats[static_cast<size_t>(path_)] = call;
+    lock_guard guard(aggregate_mutex);
+    AllocationStats& total = aggregate_stats[static_cast<size_t>(path_)];
+    ++total.calls;
+    total.allocations += call.allocations;
+    total.bytes += call.bytes;
+    total.string_copies += call.string_copies;
+}
+
+#else
+
+bool IsAllocationStatsEnabled() {
+    return false;
+}
+
+AllocationStats GetThreadAllocationStats() {
+    return {};
+}
+
+AllocationStats GetLastCallAllocationStats(HotPath) {
+    return {};
+}
+
+AllocationStats GetAggregateAllocationStats(HotPath) {
+    return {};
+}
+
+void ResetAllocationStats() {
+}
+
+#endif
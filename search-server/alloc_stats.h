@@ -0,0 +1,62 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+// Heap allocation and string copy counters for the hot path. Counting is compiled in only
+// with -DSEARCH_SERVER_ALLOC_STATS, which also replaces the global operator new/delete;
+// otherwise the probes are empty and every getter returns zeros.
+// Counters are per thread: work done by parallel algorithm workers isn't attributed to the call.
+
+struct AllocationStats {
+    uint64_t calls = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    uint64_t string_copies = 0;
+};
+
+enum class HotPath {
+    ADD_DOCUMENT,
+    FIND_TOP_DOCUMENTS,
+    MATCH_DOCUMENT,
+    REMOVE_DOCUMENT,
+};
+
+bool IsAllocationStatsEnabled();
+// Running totals of the calling thread
+AllocationStats GetThreadAllocationStats();
+// What the last call on the calling thread cost
+AllocationStats GetLastCallAllocationStats(HotPath path);
+// Sum over all calls on all threads since the last reset
+AllocationStats GetAggregateAllocationStats(HotPath path);
+void ResetAllocationStats();
+
+#ifdef SEARCH_SERVER_ALLOC_STATS
+void CountStringCopy();
+
+class AllocationProbe {
+public:
+    explicit AllocationProbe(HotPath path);
+    AllocationProbe(const AllocationProbe&) = delete;
+    AllocationProbe& operator=(const AllocationProbe&) = delete;
+    ~AllocationProbe();
+private:
+    HotPath path_;
+    AllocationStats start_;
+};
+#else
+class AllocationProbe {
+public:
+    explicit AllocationProbe(HotPath) {
+    }
+};
+inline void CountStringCopy() {
+}
+#endif
+
+
+// Use instead of std::string(text) on the hot path so copies show up in the counters
+inline std::string CopyString(std::string_view text) {
+    CountStringCopy();
+    return std::string(text);
+}
@@ -0,0 +1,82 @@
+#include "arena.h"
+#include <new>
+#include <numeric>
+#include <algorithm>
+
+using namespace std;
+
+ArenaResource::ArenaResource(size_t initial_capacity, size_t max_retained_capacity)
+    : max_retained_capacity_(max_retained_capacity)
+{
+    blocks_.reserve(8);
+    AddBlock(max<size_t>(initial_capacity, 1024));
+}
+
+void ArenaResource::Reset() {
+    const size_t capacity = GetCapacity();
+    const size_t retained_capacity = max<size_t>(min(capacity, max_retained_capacity_), 1024);
+    if (blocks_.size() > 1 || retained_capacity < capacity) {
+        blocks_.clear();
+        AddBlock(retained_capacity);
+    }
+    current_block_ = 0;
+    offset_ = 0;
+}
+
+size_t ArenaResource::GetCapacity() const {
+    return accumulate(blocks_.begin(), blocks_.end(), size_t{0},
+                      [](size_t sum, const Block& block) { return sum + block.size; });
+}
+
+void ArenaResource::SetMaxRetainedCapacity(size_t max_retained_capacity) {
+    max_retained_capacity_ = max_retained_capacity;
+}
+
+size_t ArenaResource::GetUpstreamAllocationCount() const {
+    return upstream_allocations_;
+}
+
+ArenaResource::Scope::Scope(ArenaResource& arena)
+    : arena_(arena)
+{
+    ++arena_.scope_depth_;
+}
+
+ArenaResource::Scope::~Scope() {
+    if (--arena_.scope_depth_ == 0) {
+        arena_.Reset();
+    }
+}
+
+void ArenaResource::AddBlock(size_t size) {
+    blocks_.push_back({make_unique<byte[]>(size), size});
+    ++upstream_allocations_;
+}
+
+void* ArenaResource::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        Block& block = blocks_[current_block_];
+        const size_t aligned_offset = (offset_ + alignment - 1) / alignment * alignment;
+        if (aligned_offset + bytes <= block.size) {
+            offset_ = aligned_offset + bytes;
+            return block.data.get() + aligned_offset;
+        }
+        if (current_block_ + 1 == blocks_.size()) {
+            AddBlock(max(block.size * 2, bytes + alignment));
+        }
+        ++current_block_;
+        offset_ = 0;
+    }
+}
+
+void ArenaResource::do_deallocate(void*, size_t, size_t) {
+}
+
+bool ArenaResource::do_is_equal(const pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+ArenaResource& GetThreadQueryArena() {
+    thread_local ArenaResource arena;
+    return arena;
+}
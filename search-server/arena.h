@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <memory_resource>
+
+// Bump allocator that keeps its memory between queries. Reset() rewinds it; when a query
+// overflowed into several blocks they are merged into one, so after warm-up queries of
+// the same size don't touch the global heap at all. The merged block is capped by
+// max_retained_capacity, so one outsized query doesn't pin its memory for good. Not thread-safe.
+class ArenaResource : public std::pmr::memory_resource {
+public:
+    explicit ArenaResource(size_t initial_capacity = 64 * 1024, size_t max_retained_capacity = 16 * 1024 * 1024);
+    
+    void Reset();
+    size_t GetCapacity() const;
+    // Takes effect on the next Reset
+    void SetMaxRetainedCapacity(size_t max_retained_capacity);
+    // Blocks requested from the global heap since construction
+    size_t GetUpstreamAllocationCount() const;
+    
+    // Rewinds the arena when the outermost scope on it ends, so nested queries are safe
+    class Scope {
+    public:
+        explicit Scope(ArenaResource& arena);
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+    private:
+        ArenaResource& arena_;
+    };
+private:
+    struct Block {
+        std::unique_ptr<std::byte[]> data;
+        size_t size;
+    };
+    
+    std::vector<Block> blocks_;
+    size_t current_block_ = 0;
+    size_t offset_ = 0;
+    size_t max_retained_capacity_;
+    size_t upstream_allocations_ = 0;
+    int scope_depth_ = 0;
+    
+    void AddBlock(size_t size);
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+};
+
+// Arena used by the query path of the calling thread
+ArenaResource& GetThreadQueryArena();
@@ -0,0 +1,200 @@
+#include "corpus_loader.h"
+#include <thread>
+#include <charconv>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+MappedFile::MappedFile(const string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw runtime_error("Can't open "s + path);
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        throw runtime_error("Can't stat "s + path);
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            close(fd);
+            throw runtime_error("Can't map "s + path);
+        }
+        madvise(data_, size_, MADV_SEQUENTIAL);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(data_, size_);
+    }
+}
+
+string_view MappedFile::GetContents() const {
+    return {static_cast<const char*>(data_), size_};
+}
+
+vector<string_view> SplitIntoLineChunks(string_view contents, size_t chunk_count) {
+    vector<string_view> chunks;
+    const size_t chunk_size = max<size_t>(contents.size() / max<size_t>(chunk_count, 1), 1);
+    while (!contents.empty()) {
+        size_t chunk_end = contents.find('\n', min(chunk_size, contents.size()) - 1);
+        chunk_end = chunk_end == string_view::npos ? contents.size() : chunk_end + 1;
+        chunks.push_back(contents.substr(0, chunk_end));
+        contents.remove_prefix(chunk_end);
+    }
+    return chunks;
+}
+
+namespace {
+int ParseInt(string_view text, string_view line) {
+    int value = 0;
+    const auto [last, error] = from_chars(text.data(), text.data() + text.size(), value);
+    if (error != errc() || last != text.data() + text.size()) {
+        throw invalid_argument("Malformed corpus line: "s + string(line));
+    }
+    return value;
+}
+
+DocumentStatus ParseStatus(string_view text, string_view line) {
+    static const pair<string_view, DocumentStatus> names[] = {
+        {"ACTUAL"sv, DocumentStatus::ACTUAL},
+        {"IRRELEVANT"sv, DocumentStatus::IRRELEVANT},
+        {"BANNED"sv, DocumentStatus::BANNED},
+        {"REMOVED"sv, DocumentStatus::REMOVED},
+    };
+    for (const auto& [name, status] : names) {
+        if (text == name) {
+            return status;
+        }
+    }
+    const int status = ParseInt(text, line);
+    if (status < 0 || status > static_cast<int>(DocumentStatus::REMOVED)) {
+        throw invalid_argument("Malformed corpus line: "s + string(line));
+    }
+    return static_cast<DocumentStatus>(status);
+}
+
+string_view NextField(string_view& line, string_view full_line) {
+    const size_t tab = line.find('\t');
+    if (tab == string_view::npos) {
+        throw invalid_argument("Malformed corpus line: "s + string(full_line));
+    }
+    const string_view field = line.substr(0, tab);
+    line.remove_prefix(tab + 1);
+    return field;
+}
+
+DocumentInput ParseTsvLine(string_view line) {
+    string_view rest = line;
+    DocumentInput document;
+    document.id = ParseInt(NextField(rest, line), line);
+    document.status = ParseStatus(NextField(rest, line), line);
+    string_view ratings = NextField(rest, line);
+    while (!ratings.empty()) {
+        const size_t space = ratings.find(' ');
+        const string_view rating = ratings.substr(0, space);
+        if (!rating.empty()) {
+            document.ratings.push_back(ParseInt(rating, line));
+        }
+        ratings.remove_prefix(space == string_view::npos ? ratings.size() : space + 1);
+    }
+    document.text = rest;
+    return document;
+}
+
+vector<DocumentInput> ParseChunk(string_view chunk, CorpusFormat format) {
+    vector<DocumentInput> documents;
+    while (!chunk.empty()) {
+        const size_t line_end = chunk.find('\n');
+        string_view line = chunk.substr(0, line_end);
+        chunk.remove_prefix(line_end == string_view::npos ? chunk.size() : line_end + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.empty()) {
+            continue;
+        }
+        if (format == CorpusFormat::TSV) {
+            documents.push_back(ParseTsvLine(line));
+        } else {
+            DocumentInput document;
+            document.text = line;
+            documents.push_back(move(document));
+        }
+    }
+    return documents;
+}
+
+template <typename ExecutionPolicy>
+vector<DocumentInput> ParseCorpusImpl(ExecutionPolicy&& policy, string_view contents, CorpusFormat format, int first_id) {
+    const size_t chunk_count = is_same_v<decay_t<ExecutionPolicy>, execution::sequenced_policy>
+        ? 1 : max(thread::hardware_concurrency(), 1u) * 4;
+    const vector<string_view> chunks = SplitIntoLineChunks(contents, chunk_count);
+    vector<vector<DocumentInput>> parsed(chunks.size());
+    vector<exception_ptr> errors(chunks.size());
+    vector<size_t> indexes(chunks.size());
+    iota(indexes.begin(), indexes.end(), 0);
+    for_each(policy, indexes.begin(), indexes.end(),
+             [&](size_t i)
+             {
+                 try {
+                     parsed[i] = ParseChunk(chunks[i], format);
+                 } catch (...) {
+                     errors[i] = current_exception();
+                 }
+             }
+            );
+    
+    vector<DocumentInput> documents;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        if (errors[i]) {
+            rethrow_exception(errors[i]);
+        }
+        move(parsed[i].begin(), parsed[i].end(), back_inserter(documents));
+    }
+    if (format == CorpusFormat::LINES) {
+        for (size_t i = 0; i < documents.size(); ++i) {
+            documents[i].id = first_id + static_cast<int>(i);
+        }
+    }
+    return documents;
+}
+
+template <typename ExecutionPolicy>
+size_t LoadCorpusImpl(ExecutionPolicy&& policy, SearchServer& search_server, const string& path,
+                      CorpusFormat format, int first_id) {
+    const MappedFile file(path);
+    const vector<DocumentInput> documents = ParseCorpus(policy, file.GetContents(), format, first_id);
+    search_server.AddDocuments(policy, documents);
+    return documents.size();
+}
+}
+
+vector<DocumentInput> ParseCorpus(execution::sequenced_policy policy, string_view contents,
+                                  CorpusFormat format, int first_id) {
+    return ParseCorpusImpl(policy, contents, format, first_id);
+}
+
+vector<DocumentInput> ParseCorpus(execution::parallel_policy policy, string_view contents,
+                                  CorpusFormat format, int first_id) {
+    return ParseCorpusImpl(policy, contents, format, first_id);
+}
+
+size_t LoadCorpus(execution::sequenced_policy policy, SearchServer& search_server, const string& path,
+                  CorpusFormat format, int first_id) {
+    return LoadCorpusImpl(policy, search_server, path, format, first_id);
+}
+
+size_t LoadCorpus(execution::parallel_policy policy, SearchServer& search_server, const string& path,
+                  CorpusFormat format, int first_id) {
+    return LoadCorpusImpl(policy, search_server, path, format, first_id);
+}
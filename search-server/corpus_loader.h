@@ -0,0 +1,39 @@
+#pragma once
+#include "search_server.h"
+
+enum class CorpusFormat {
+    // one document text per line, non-empty lines get consecutive ids, ACTUAL status, no ratings
+    LINES,
+    // id<TAB>status<TAB>ratings<TAB>text, status is a number or a name (ACTUAL, BANNED, ...),
+    // ratings are separated by spaces
+    TSV,
+};
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+    
+    std::string_view GetContents() const;
+private:
+    void* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+// Splits contents into about chunk_count pieces, each ending at a line boundary
+std::vector<std::string_view> SplitIntoLineChunks(std::string_view contents, size_t chunk_count);
+
+// Returned texts point into contents
+std::vector<DocumentInput> ParseCorpus(std::execution::sequenced_policy, std::string_view contents,
+                                       CorpusFormat format, int first_id = 0);
+std::vector<DocumentInput> ParseCorpus(std::execution::parallel_policy, std::string_view contents,
+                                       CorpusFormat format, int first_id = 0);
+
+// Maps the file, parses it and adds all documents in bulk, returns the number of added documents
+size_t LoadCorpus(std::execution::sequenced_policy, SearchServer& search_server, const std::string& path,
+                  CorpusFormat format, int first_id = 0);
+size_t LoadCorpus(std::execution::parallel_policy, SearchServer& search_server, const std::string& path,
+                  CorpusFormat format, int first_id = 0);
@@ -10,11 +10,15 @@ ostream& operator<<(ostream& out, const Document& document) {
     return out;
 }
 
+ostream& operator<<(ostream& out, const CompactDocument& document) {
+    return out << static_cast<Document>(document);
+}
+
 void PrintDocument(const Document& document) {
     cout << "{ "s
          << "document_id = "s << document.id << ", "s
          << "relevance = "s << document.relevance << ", "s
-         << "rating = "s << document.rating << " }"s << endl;
+         << "rating = "s << document.rating << " }"s << '\n';
 }
 
 void PrintMatchDocumentResult(int document_id, const vector<string_view>& words, DocumentStatus status) {
@@ -25,5 +29,5 @@ void PrintMatchDocumentResult(int document_id, const vector<string_view>& words,
     for (const auto& word : words) {
         cout << ' ' << word;
     }
-    cout << "}"s << endl;
+    cout << "}"s << '\n';
 }
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 #include <vector>
+#include <cstdint>
+#include <type_traits>
 #include <string>
 #include <iostream>
 #include <string_view>
@@ -16,6 +18,28 @@ struct Document {
     int rating = 0;
 };
 
+// 12-byte result for bulk runs, relevance is narrowed to float; converts to Document at the API edge
+struct CompactDocument {
+    CompactDocument() = default;
+    CompactDocument(int id, double relevance, int rating)
+        : id(id)
+        , relevance(static_cast<float>(relevance))
+        , rating(rating) {
+    }
+    explicit CompactDocument(const Document& document)
+        : CompactDocument(document.id, document.relevance, document.rating) {
+    }
+    explicit operator Document() const {
+        return {id, relevance, rating};
+    }
+    int32_t id = 0;
+    float relevance = 0.0f;
+    int32_t rating = 0;
+};
+
+static_assert(sizeof(CompactDocument) == 12 && std::is_trivially_copyable_v<CompactDocument>,
+              "CompactDocument must stay a packed trivially copyable record");
+
 enum class DocumentStatus {
     ACTUAL,
     IRRELEVANT,
@@ -23,6 +47,15 @@ enum class DocumentStatus {
     REMOVED,
 };
 
+// Input of bulk indexing, text is not owned
+struct DocumentInput {
+    int id = 0;
+    DocumentStatus status = DocumentStatus::ACTUAL;
+    std::vector<int> ratings;
+    std::string_view text;
+};
+
 std::ostream& operator<<(std::ostream& out, const Document& document);
+std::ostream& operator<<(std::ostream& out, const CompactDocument& document);
 void PrintDocument(const Document& document);
 void PrintMatchDocumentResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status);
\ No newline at end of file
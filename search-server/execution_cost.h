@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <thread>
+#include <type_traits>
+
+// Policy tag: the server estimates the work of the call and runs it with
+// std::execution::seq or std::execution::par
+struct AutoExecutionPolicy {
+};
+
+inline constexpr AutoExecutionPolicy execution_auto{};
+
+template <typename ExecutionPolicy>
+inline constexpr bool IS_AUTO_EXECUTION_POLICY = std::is_same_v<std::decay_t<ExecutionPolicy>, AutoExecutionPolicy>;
+
+// Work sizes from which par beats seq. The crossovers depend on the machine, the defaults
+// are conservative; `search-server --calibrate` measures them on the target host.
+struct ExecutionThresholds {
+    // postings of the query's words; queries with a single plus word always run seq,
+    // the parallel path splits the work by word
+    size_t query_postings = 50000;
+    // words of a query matched against one document
+    size_t match_words = 512;
+    // postings erased by a removal, or posting lists swept when there is no forward index
+    size_t removal_postings = 20000;
+};
+
+// On a single hardware thread par only adds overhead
+inline bool HasParallelHardware() {
+    static const bool has_parallel_hardware = std::thread::hardware_concurrency() > 1;
+    return has_parallel_hardware;
+}
\ No newline at end of file
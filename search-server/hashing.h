@@ -0,0 +1,12 @@
+#pragma once
+#include <cstdint>
+
+// splitmix64 finalizer, spreads every input bit over the whole word
+inline uint64_t MixBits(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
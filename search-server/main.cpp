@@ -1,11 +1,359 @@
+#include "corpus_loader.h"
 #include "process_queries.h"
+#include "result_writer.h"
 #include "search_server.h"
+#include <algorithm>
 #include <execution>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
 #include <string>
 #include <vector>
 using namespace std;
-int main() {
+
+namespace {
+struct BatchOptions {
+    string corpus_path;
+    CorpusFormat corpus_format = CorpusFormat::TSV;
+    string queries_path;
+    string stop_words;
+    // words found in more than this share of the documents are ignored in queries
+    double stop_word_ratio = 1.0;
+    size_t batch_size = 10000;
+    ResultFormat output_format = ResultFormat::TEXT;
+    // approximate_postings_per_term values to evaluate instead of writing results
+    vector<size_t> recall_levels;
+};
+
+void PrintUsage(const char* program) {
+    cerr << "Usage: "s << program << " --corpus FILE [--format tsv|lines] [--queries FILE]"s
+         << " [--stop-words \"WORDS\"] [--stop-word-ratio R] [--batch-size N] [--output text|json|binary]"s
+         << " [--recall-levels M1,M2,...]\n"s
+         << "       "s << program << " --calibrate\n"s
+         << "Without arguments runs the demo. Queries are read from stdin unless --queries is given.\n"s
+         << "--stop-word-ratio ignores query plus words found in more than R (0 < R <= 1) of the documents.\n"s
+         << "--recall-levels compares approximate queries with each approximate_postings_per_term\n"s
+         << "against the exact ones and prints recall and latency instead of the results.\n"s
+         << "--calibrate times seq against par and prints thresholds for the execution_auto policy.\n"s;
+}
+
+bool ParseBatchOptions(int argc, char* argv[], BatchOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        const string_view arg = argv[i];
+        if (i + 1 == argc) {
+            return false;
+        }
+        const string value = argv[++i];
+        if (arg == "--corpus"sv) {
+            options.corpus_path = value;
+        } else if (arg == "--format"sv && (value == "tsv"s || value == "lines"s)) {
+            options.corpus_format = value == "tsv"s ? CorpusFormat::TSV : CorpusFormat::LINES;
+        } else if (arg == "--queries"sv) {
+            options.queries_path = value;
+        } else if (arg == "--stop-words"sv) {
+            options.stop_words = value;
+        } else if (arg == "--stop-word-ratio"sv && stod(value) > 0.0 && stod(value) <= 1.0) {
+            options.stop_word_ratio = stod(value);
+        } else if (arg == "--recall-levels"sv) {
+            string levels = value;
+            replace(levels.begin(), levels.end(), ',', ' ');
+            for (const string& level : SplitIntoWords(levels)) {
+                if (stoul(level) == 0) {
+                    return false;
+                }
+                options.recall_levels.push_back(stoul(level));
+            }
+        } else if (arg == "--batch-size"sv && stoul(value) > 0) {
+            options.batch_size = stoul(value);
+        } else if (arg == "--output"sv && value == "text"s) {
+            options.output_format = ResultFormat::TEXT;
+        } else if (arg == "--output"sv && value == "json"s) {
+            options.output_format = ResultFormat::JSON;
+        } else if (arg == "--output"sv && value == "binary"s) {
+            options.output_format = ResultFormat::BINARY;
+        } else {
+            return false;
+        }
+    }
+    return !options.corpus_path.empty();
+}
+
+bool ReadQueryBatch(istream& input, size_t batch_size, vector<string>& queries) {
+    queries.clear();
+    string query;
+    while (queries.size() < batch_size && getline(input, query)) {
+        if (!query.empty() && query.back() == '\r') {
+            query.pop_back();
+        }
+        queries.push_back(move(query));
+    }
+    return !queries.empty();
+}
+
+double ToMilliseconds(chrono::nanoseconds duration) {
+    return chrono::duration<double, milli>(duration).count();
+}
+
+// Worded as the exceptions of the throwing API
+string DescribeQueryError(const ParseError& error) {
+    if (error.word.empty()) {
+        return "Query word is empty"s;
+    }
+    return "Query word "s + string(error.word) + " is invalid"s;
+}
+
+// Recall over the queries with exact results: the share of the exact top documents that
+// the approximate query found as well. Malformed queries are reported and left out.
+int RunRecallEvaluation(const SearchServer& search_server, const vector<string>& all_queries, const vector<size_t>& levels) {
+    using Clock = chrono::steady_clock;
+    vector<string> queries;
+    vector<vector<Document>> exact_results;
+    const auto exact_start = Clock::now();
+    for (const string& query : all_queries) {
+        try {
+            exact_results.push_back(search_server.FindTopDocuments(query));
+            queries.push_back(query);
+        } catch (const invalid_argument& e) {
+            cerr << "Skipped query \""s << query << "\": "s << e.what() << '\n';
+        }
+    }
+    const auto exact_time = Clock::now() - exact_start;
+    if (queries.empty()) {
+        cerr << "No queries to evaluate\n"s;
+        return 1;
+    }
+    cout << "exact: "s << ToMilliseconds(exact_time) / queries.size() << " ms/query\n"s;
+    
+    for (const size_t level : levels) {
+        QueryOptions query_options;
+        query_options.approximate_postings_per_term = level;
+        vector<SearchResult> results(queries.size());
+        const auto start = Clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            results[i] = search_server.FindTopDocuments(queries[i], query_options);
+        }
+        const auto time = Clock::now() - start;
+        
+        double recall_sum = 0.0;
+        size_t evaluated = 0;
+        size_t approximated = 0;
+        for (size_t i = 0; i < queries.size(); ++i) {
+            approximated += results[i].is_approximate ? 1 : 0;
+            if (exact_results[i].empty()) {
+                continue;
+            }
+            size_t found = 0;
+            for (const Document& document : exact_results[i]) {
+                found += any_of(results[i].documents.begin(), results[i].documents.end(), [&document](const Document& result) {
+                    return result.id == document.id;
+                }) ? 1 : 0;
+            }
+            recall_sum += static_cast<double>(found) / exact_results[i].size();
+            ++evaluated;
+        }
+        cout << "approximate_postings_per_term "s << level
+             << ": recall@"s << MAX_RESULT_DOCUMENT_COUNT << ' ' << (evaluated > 0 ? recall_sum / evaluated : 1.0)
+             << ", "s << ToMilliseconds(time) / queries.size() << " ms/query, "s
+             << approximated << " of "s << queries.size() << " queries approximate\n"s;
+    }
+    return 0;
+}
+
+int RunBatch(const BatchOptions& options) {
+    using Clock = chrono::steady_clock;
+    SearchServerOptions server_options;
+    server_options.max_query_document_ratio = options.stop_word_ratio;
+    SearchServer search_server(options.stop_words, server_options);
+    const auto load_start = Clock::now();
+    const size_t document_count = LoadCorpus(execution::par, search_server, options.corpus_path, options.corpus_format);
+    const auto load_time = Clock::now() - load_start;
+    cerr << "Loaded "s << document_count << " documents in "s << ToMilliseconds(load_time) << " ms\n"s;
+    if (options.stop_word_ratio < 1.0) {
+        cerr << "Query stop words:"s;
+        for (const TermStatistics& term : search_server.SuggestStopWords(options.stop_word_ratio)) {
+            cerr << ' ' << term.word << " ("s << term.document_freq << ')';
+        }
+        cerr << '\n';
+    }
+    
+    ifstream queries_file;
+    if (!options.queries_path.empty()) {
+        queries_file.open(options.queries_path);
+        if (!queries_file) {
+            cerr << "Can't open "s << options.queries_path << '\n';
+            return 1;
+        }
+    }
+    istream& queries_input = options.queries_path.empty() ? cin : queries_file;
+    
+    vector<string> queries;
+    if (!options.recall_levels.empty()) {
+        ReadQueryBatch(queries_input, numeric_limits<size_t>::max(), queries);
+        return RunRecallEvaluation(search_server, queries, options.recall_levels);
+    }
+    
+    ResultWriter writer(cout, options.output_format);
+    vector<chrono::nanoseconds> latencies;
+    vector<chrono::nanoseconds> all_latencies;
+    chrono::nanoseconds search_time{0};
+    size_t error_count = 0;
+    while (ReadQueryBatch(queries_input, options.batch_size, queries)) {
+        const auto batch_start = Clock::now();
+        const auto results = ProcessQueries(search_server, queries, latencies);
+        search_time += Clock::now() - batch_start;
+        for (size_t i = 0; i < results.size(); ++i) {
+            // JSON and binary delimit each query's documents themselves, text gets a header
+            // line per query so that queries without results still show up
+            if (options.output_format == ResultFormat::TEXT) {
+                writer.WriteLine("Query: "s + queries[i]);
+            }
+            if (results[i]) {
+                writer.WriteDocuments(*results[i]);
+            } else {
+                const string message = DescribeQueryError(results[i].error());
+                cerr << "Query "s << all_latencies.size() + i + 1 << " \""s << queries[i] << "\": "s << message << '\n';
+                writer.WriteError(message);
+                ++error_count;
+            }
+        }
+        writer.Flush();
+        all_latencies.insert(all_latencies.end(), latencies.begin(), latencies.end());
+    }
+    writer.Flush();
+    
+    const size_t query_count = all_latencies.size();
+    cerr << "Queries: "s << query_count << ", errors: "s << error_count << ", search time: "s << ToMilliseconds(search_time) << " ms"s;
+    if (query_count > 0) {
+        sort(all_latencies.begin(), all_latencies.end());
+        auto percentile = [&all_latencies](double p) {
+            return ToMilliseconds(all_latencies[min(all_latencies.size() - 1, static_cast<size_t>(p * all_latencies.size()))]);
+        };
+        cerr << ", throughput: "s << query_count / chrono::duration<double>(search_time).count() << " qps\n"s
+             << "Latency ms: p50 "s << percentile(0.5) << ", p90 "s << percentile(0.9)
+             << ", p99 "s << percentile(0.99) << ", max "s << ToMilliseconds(all_latencies.back());
+    }
+    cerr << '\n';
+    return 0;
+}
+
+template <typename Function>
+chrono::nanoseconds MedianTime(int repetitions, Function function) {
+    vector<chrono::nanoseconds> times;
+    for (int i = 0; i < repetitions; ++i) {
+        const auto start = chrono::steady_clock::now();
+        function();
+        times.push_back(chrono::steady_clock::now() - start);
+    }
+    nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+    return times[times.size() / 2];
+}
+
+// Smallest measured size from which par won every larger measurement as well
+string FindCrossover(const vector<tuple<size_t, chrono::nanoseconds, chrono::nanoseconds>>& measurements) {
+    string threshold = "never"s;
+    for (auto it = measurements.rbegin(); it != measurements.rend() && get<2>(*it) < get<1>(*it); ++it) {
+        threshold = to_string(get<0>(*it));
+    }
+    return threshold;
+}
+
+void PrintMeasurements(string_view name, const vector<tuple<size_t, chrono::nanoseconds, chrono::nanoseconds>>& measurements) {
+    for (const auto& [size, seq_time, par_time] : measurements) {
+        cout << name << ' ' << size << ": seq "s << ToMilliseconds(seq_time) << " ms, par "s
+             << ToMilliseconds(par_time) << " ms\n"s;
+    }
+}
+
+// Synthetic corpus with log-uniform word frequencies, so posting lists span all sizes
+int RunCalibration() {
+    const int document_count = 100000;
+    const int vocabulary_size = 20000;
+    const int words_per_document = 10;
+    mt19937 generator(42);
+    uniform_real_distribution<double> exponent(0.0, 1.0);
+    auto random_word = [&]() {
+        return "w"s + to_string(static_cast<int>(pow(vocabulary_size, exponent(generator))) - 1);
+    };
+    vector<string> texts(document_count);
+    vector<DocumentInput> documents(document_count);
+    map<string, size_t> document_freqs;
+    for (int id = 0; id < document_count; ++id) {
+        set<string> words;
+        for (int i = 0; i < words_per_document; ++i) {
+            words.insert(random_word());
+        }
+        for (const string& word : words) {
+            texts[id] += word + ' ';
+            ++document_freqs[word];
+        }
+        documents[id] = {id, DocumentStatus::ACTUAL, {id % 10}, texts[id]};
+    }
+    // champion lists would answer the frequent-word queries and hide the full scoring being timed
+    SearchServerOptions server_options;
+    server_options.champion_list_size = 0;
+    SearchServer search_server(""s, server_options);
+    search_server.AddDocuments(execution::par, documents);
+    
+    using Measurements = vector<tuple<size_t, chrono::nanoseconds, chrono::nanoseconds>>;
+    Measurements queries;
+    for (int rank = 1; rank < vocabulary_size; rank *= 2) {
+        const string query = "w"s + to_string(rank - 1) + " w"s + to_string(rank);
+        const size_t posting_count = document_freqs["w"s + to_string(rank - 1)] + document_freqs["w"s + to_string(rank)];
+        queries.emplace_back(posting_count,
+                             MedianTime(15, [&] { search_server.FindTopDocuments(execution::seq, query); }),
+                             MedianTime(15, [&] { search_server.FindTopDocuments(execution::par, query); }));
+    }
+    sort(queries.begin(), queries.end());
+    
+    Measurements matches;
+    for (size_t word_count = 1; word_count <= 1024; word_count *= 2) {
+        string query;
+        for (size_t i = 0; i < word_count; ++i) {
+            query += random_word() + ' ';
+        }
+        matches.emplace_back(word_count,
+                             MedianTime(15, [&] { search_server.MatchDocument(execution::seq, query, 0); }),
+                             MedianTime(15, [&] { search_server.MatchDocument(execution::par, query, 0); }));
+    }
+    
+    Measurements removals;
+    for (int batch_size = 1; batch_size <= 4096; batch_size *= 4) {
+        const vector<DocumentInput> batch(documents.begin(), documents.begin() + batch_size);
+        vector<int> batch_ids;
+        size_t posting_count = 0;
+        for (const DocumentInput& document : batch) {
+            batch_ids.push_back(document.id);
+            posting_count += search_server.GetWordFrequencies(document.id).size();
+        }
+        // only the removal is timed, the batch is added back after every run
+        auto time_removal = [&](auto policy) {
+            vector<chrono::nanoseconds> times;
+            for (int i = 0; i < 5; ++i) {
+                const auto start = chrono::steady_clock::now();
+                search_server.RemoveDocuments(policy, batch_ids);
+                times.push_back(chrono::steady_clock::now() - start);
+                search_server.AddDocuments(execution::seq, batch);
+            }
+            nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+            return times[times.size() / 2];
+        };
+        removals.emplace_back(posting_count, time_removal(execution::seq), time_removal(execution::par));
+    }
+    
+    PrintMeasurements("query_postings"sv, queries);
+    PrintMeasurements("match_words"sv, matches);
+    PrintMeasurements("removal_postings"sv, removals);
+    cout << "Thresholds: query_postings "s << FindCrossover(queries)
+         << ", match_words "s << FindCrossover(matches)
+         << ", removal_postings "s << FindCrossover(removals) << '\n';
+    return 0;
+}
+
+void RunDemo() {
     SearchServer search_server("and with"s);
     int id = 0;
     for (
@@ -33,5 +381,26 @@ int main() {
     for (const Document& document : search_server.FindTopDocuments(execution::par, "curly nasty cat"s, [](int document_id, DocumentStatus status, int rating) { return document_id % 2 == 0; })) {
         PrintDocument(document);
     }
-    return 0;
-}
\ No newline at end of file
+}
+}
+
+int main(int argc, char* argv[]) {
+    if (argc == 1) {
+        RunDemo();
+        return 0;
+    }
+    try {
+        if (argc == 2 && argv[1] == "--calibrate"sv) {
+            return RunCalibration();
+        }
+        BatchOptions options;
+        if (!ParseBatchOptions(argc, argv, options)) {
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        return RunBatch(options);
+    } catch (const exception& e) {
+        cerr << "Error: "s << e.what() << '\n';
+        return 1;
+    }
+}
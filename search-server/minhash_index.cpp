@@ -0,0 +1,106 @@
+#include "minhash_index.h"
+#include "hashing.h"
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+MinHashIndex::MinHashIndex(size_t signature_size, size_t band_count)
+    : signature_size_(signature_size)
+    , rows_per_band_(band_count == 0 ? 0 : signature_size / band_count)
+    , bands_(band_count)
+{
+    if (band_count == 0 || signature_size == 0 || signature_size % band_count != 0) {
+        throw invalid_argument("Signature size must be a positive multiple of band count"s);
+    }
+}
+
+void MinHashIndex::RemoveDocument(int document_id) {
+    const auto it = signatures_.find(document_id);
+    if (it == signatures_.end()) {
+        return;
+    }
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        const auto bucket_it = bands_[band].find(ComputeBandKey(it->second, band));
+        auto& bucket = bucket_it->second;
+        bucket.erase(find(bucket.begin(), bucket.end(), document_id));
+        if (bucket.empty()) {
+            bands_[band].erase(bucket_it);
+        }
+    }
+    signatures_.erase(it);
+}
+
+double MinHashIndex::EstimateSimilarity(int lhs_id, int rhs_id) const {
+    const auto lhs = signatures_.find(lhs_id);
+    const auto rhs = signatures_.find(rhs_id);
+    if (lhs == signatures_.end() || rhs == signatures_.end()) {
+        return 0.0;
+    }
+    size_t equal_count = 0;
+    for (size_t i = 0; i < signature_size_; ++i) {
+        equal_count += lhs->second[i] == rhs->second[i];
+    }
+    return equal_count * 1.0 / signature_size_;
+}
+
+vector<pair<int, double>> MinHashIndex::FindNearDuplicates(int document_id, double threshold) const {
+    vector<pair<int, double>> result;
+    for (const int candidate_id : FindCandidates(document_id)) {
+        const double similarity = EstimateSimilarity(document_id, candidate_id);
+        if (similarity >= threshold) {
+            result.emplace_back(candidate_id, similarity);
+        }
+    }
+    sort(result.begin(), result.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second > rhs.second || (lhs.second == rhs.second && lhs.first < rhs.first);
+    });
+    return result;
+}
+
+uint64_t MinHashIndex::HashWord(string_view word) {
+    return MixBits(hash<string_view>{}(word));
+}
+
+vector<uint64_t> MinHashIndex::ComputeSignature(const vector<uint64_t>& word_hashes) const {
+    vector<uint64_t> signature(signature_size_, numeric_limits<uint64_t>::max());
+    for (size_t i = 0; i < signature_size_; ++i) {
+        const uint64_t seed = MixBits(i + 1);
+        for (const uint64_t word_hash : word_hashes) {
+            signature[i] = min(signature[i], MixBits(word_hash ^ seed));
+        }
+    }
+    return signature;
+}
+
+uint64_t MinHashIndex::ComputeBandKey(const vector<uint64_t>& signature, size_t band) const {
+    uint64_t key = band;
+    for (size_t row = band * rows_per_band_; row < (band + 1) * rows_per_band_; ++row) {
+        key = MixBits(key ^ signature[row]);
+    }
+    return key;
+}
+
+void MinHashIndex::IndexSignature(int document_id, vector<uint64_t> signature) {
+    RemoveDocument(document_id);
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        bands_[band][ComputeBandKey(signature, band)].push_back(document_id);
+    }
+    signatures_[document_id] = move(signature);
+}
+
+vector<int> MinHashIndex::FindCandidates(int document_id) const {
+    vector<int> candidates;
+    const auto it = signatures_.find(document_id);
+    if (it == signatures_.end()) {
+        return candidates;
+    }
+    for (size_t band = 0; band < bands_.size(); ++band) {
+        const auto& bucket = bands_[band].at(ComputeBandKey(it->second, band));
+        copy_if(bucket.begin(), bucket.end(), back_inserter(candidates),
+                [document_id](int id) { return id != document_id; });
+    }
+    sort(candidates.begin(), candidates.end());
+    candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+    return candidates;
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <execution>
+#include <string_view>
+#include <unordered_map>
+
+// MinHash signatures of document word sets with an LSH banding index.
+// Signatures are built from word hashes, so they survive dictionary compaction.
+class MinHashIndex {
+public:
+    MinHashIndex(size_t signature_size, size_t band_count);
+    
+    template <typename WordContainer>
+    void AddDocument(int document_id, const WordContainer& words);
+    void RemoveDocument(int document_id);
+    
+    // Estimated Jaccard similarity of the word sets, 0 for unknown documents
+    double EstimateSimilarity(int lhs_id, int rhs_id) const;
+    
+    // Documents sharing an LSH bucket with document_id and estimated similarity >= threshold,
+    // most similar first
+    std::vector<std::pair<int, double>> FindNearDuplicates(int document_id, double threshold) const;
+    
+    // Connected groups of documents linked by estimated similarity >= threshold, each sorted,
+    // singletons omitted
+    template <typename ExecutionPolicy>
+    std::vector<std::vector<int>> ClusterNearDuplicates(ExecutionPolicy&& policy, double threshold) const;
+private:
+    typedef std::unordered_map<uint64_t, std::vector<int>> Band;
+    
+    size_t signature_size_;
+    size_t rows_per_band_;
+    std::map<int, std::vector<uint64_t>> signatures_;
+    std::vector<Band> bands_;
+    
+    static uint64_t HashWord(std::string_view word);
+    std::vector<uint64_t> ComputeSignature(const std::vector<uint64_t>& word_hashes) const;
+    uint64_t ComputeBandKey(const std::vector<uint64_t>& signature, size_t band) const;
+    void IndexSignature(int document_id, std::vector<uint64_t> signature);
+    std::vector<int> FindCandidates(int document_id) const;
+};
+
+template <typename WordContainer>
+void MinHashIndex::AddDocument(int document_id, const WordContainer& words) {
+    std::vector<uint64_t> word_hashes;
+    word_hashes.reserve(words.size());
+    for (const auto& word : words) {
+        word_hashes.push_back(HashWord(word.first));
+    }
+    IndexSignature(document_id, ComputeSignature(word_hashes));
+}
+
+template <typename ExecutionPolicy>
+std::vector<std::vector<int>> MinHashIndex::ClusterNearDuplicates(ExecutionPolicy&& policy, double threshold) const {
+    std::vector<int> document_ids;
+    std::unordered_map<int, size_t> positions;
+    for (const auto& [document_id, _] : signatures_) {
+        positions[document_id] = document_ids.size();
+        document_ids.push_back(document_id);
+    }
+    
+    // candidate pairs are verified per band in parallel, then merged with union-find
+    std::vector<std::vector<std::pair<size_t, size_t>>> band_edges(bands_.size());
+    std::vector<size_t> band_indexes(bands_.size());
+    std::iota(band_indexes.begin(), band_indexes.end(), 0);
+    std::for_each(policy, band_indexes.begin(), band_indexes.end(),
+                  [&](size_t band)
+                  {
+                      for (const auto& [_, bucket] : bands_[band]) {
+                          for (size_t i = 0; i < bucket.size(); ++i) {
+                              for (size_t j = i + 1; j < bucket.size(); ++j) {
+                                  if (EstimateSimilarity(bucket[i], bucket[j]) >= threshold) {
+                                      band_edges[band].emplace_back(positions.at(bucket[i]), positions.at(bucket[j]));
+                                  }
+                              }
+                          }
+                      }
+                  }
+                 );
+    
+    std::vector<size_t> parents(document_ids.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    auto find_root = [&parents](size_t node) {
+        while (parents[node] != node) {
+            parents[node] = parents[parents[node]];
+            node = parents[node];
+        }
+        return node;
+    };
+    for (const auto& edges : band_edges) {
+        for (const auto& [lhs, rhs] : edges) {
+            const size_t lhs_root = find_root(lhs);
+            const size_t rhs_root = find_root(rhs);
+            if (lhs_root != rhs_root) {
+                parents[std::max(lhs_root, rhs_root)] = std::min(lhs_root, rhs_root);
+            }
+        }
+    }
+    
+    std::map<size_t, std::vector<int>> groups;
+    for (size_t i = 0; i < document_ids.size(); ++i) {
+        groups[find_root(i)].push_back(document_ids[i]);
+    }
+    std::vector<std::vector<int>> clusters;
+    for (auto& [_, group] : groups) {
+        if (group.size() > 1) {
+            clusters.push_back(std::move(group));
+        }
+    }
+    return clusters;
+}
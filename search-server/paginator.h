@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
+#include <iterator>
 #include <iostream>
+#include <algorithm>
 
 template <typename Iterator>
 class IteratorRange {
@@ -32,32 +34,120 @@ std::ostream& operator<<(std::ostream& out, const IteratorRange<Iterator>& range
     return out;
 }
 
+// Pages are computed on access, nothing is stored besides the bounds.
+// With random access iterators any page is reached in O(1).
 template <typename Iterator>
 class Paginator {
 public:
-    Paginator(Iterator begin, Iterator end, size_t page_size) {
-        for (size_t left = distance(begin, end); left > 0;) {
-            const size_t current_page_size = std::min(page_size, left);
-            const Iterator current_page_end = next(begin, current_page_size);
-            pages_.push_back({begin, current_page_end});
-            left -= current_page_size;
-            begin = current_page_end;
+    class PageIterator {
+    public:
+        // the full random access operator set, though dereferencing yields the page by value
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = IteratorRange<Iterator>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+        
+        PageIterator() = default;
+        PageIterator(const Paginator* paginator, size_t index)
+            : paginator_(paginator)
+            , index_(index) {
         }
+        value_type operator*() const {
+            return (*paginator_)[index_];
+        }
+        value_type operator[](difference_type n) const {
+            return (*paginator_)[index_ + n];
+        }
+        PageIterator& operator++() {
+            ++index_;
+            return *this;
+        }
+        PageIterator operator++(int) {
+            PageIterator copy = *this;
+            ++index_;
+            return copy;
+        }
+        PageIterator& operator--() {
+            --index_;
+            return *this;
+        }
+        PageIterator operator--(int) {
+            PageIterator copy = *this;
+            --index_;
+            return copy;
+        }
+        PageIterator& operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+        PageIterator& operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+        PageIterator operator+(difference_type n) const {
+            return {paginator_, index_ + n};
+        }
+        PageIterator operator-(difference_type n) const {
+            return {paginator_, index_ - n};
+        }
+        difference_type operator-(const PageIterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+        bool operator==(const PageIterator& other) const {
+            return index_ == other.index_;
+        }
+        bool operator!=(const PageIterator& other) const {
+            return index_ != other.index_;
+        }
+        bool operator<(const PageIterator& other) const {
+            return index_ < other.index_;
+        }
+        bool operator>(const PageIterator& other) const {
+            return index_ > other.index_;
+        }
+        bool operator<=(const PageIterator& other) const {
+            return index_ <= other.index_;
+        }
+        bool operator>=(const PageIterator& other) const {
+            return index_ >= other.index_;
+        }
+        friend PageIterator operator+(difference_type n, const PageIterator& it) {
+            return it + n;
+        }
+    private:
+        const Paginator* paginator_ = nullptr;
+        size_t index_ = 0;
+    };
+    
+    Paginator(Iterator begin, Iterator end, size_t page_size)
+        : begin_(begin)
+        , item_count_(distance(begin, end))
+        , page_size_(page_size)
+        , size_(page_size == 0 ? 0 : (item_count_ + page_size - 1) / page_size) {
+    }
+    IteratorRange<Iterator> operator[](size_t index) const {
+        const size_t page_start = std::min(index * page_size_, item_count_);
+        const Iterator first = next(begin_, page_start);
+        return {first, next(first, std::min(page_size_, item_count_ - page_start))};
     }
-    auto begin() const {
-        return pages_.begin();
+    PageIterator begin() const {
+        return {this, 0};
     }
-    auto end() const {
-        return pages_.end();
+    PageIterator end() const {
+        return {this, size_};
     }
     size_t size() const {
-        return pages_.size();
+        return size_;
     }
 private:
-    std::vector<IteratorRange<Iterator>> pages_;
+    Iterator begin_;
+    size_t item_count_;
+    size_t page_size_;
+    size_t size_;
 };
 
 template <typename Container>
 auto Paginate(const Container& c, size_t page_size) {
     return Paginator(begin(c), end(c), page_size);
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <string>
+#include <cstddef>
+#include <utility>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+enum class ParseErrorCode {
+    OK,
+    EMPTY_WORD,
+    DOUBLE_MINUS,
+    INVALID_CHARACTER,
+    INVALID_DOCUMENT_ID,
+};
+
+// position is the byte offset in the parsed text: of the bad character for INVALID_CHARACTER,
+// of the word start otherwise; word is a view into the parsed text
+struct ParseError {
+    ParseErrorCode code = ParseErrorCode::OK;
+    size_t position = 0;
+    std::string_view word;
+    
+    explicit operator bool() const {
+        return code != ParseErrorCode::OK;
+    }
+};
+
+// Either a value or a ParseError, for the non-throwing API
+template <typename T>
+class Expected {
+public:
+    Expected(T value)
+        : value_(std::move(value)) {
+    }
+    Expected(ParseError error)
+        : error_(error) {
+    }
+    
+    bool has_value() const {
+        return value_.has_value();
+    }
+    explicit operator bool() const {
+        return has_value();
+    }
+    const T& value() const& {
+        if (!value_) {
+            using namespace std::string_literals;
+            throw std::logic_error("Expected holds an error"s);
+        }
+        return *value_;
+    }
+    T&& value() && {
+        if (!value_) {
+            using namespace std::string_literals;
+            throw std::logic_error("Expected holds an error"s);
+        }
+        return std::move(*value_);
+    }
+    const T& operator*() const {
+        return *value_;
+    }
+    const T* operator->() const {
+        return &*value_;
+    }
+    const ParseError& error() const {
+        return error_;
+    }
+private:
+    std::optional<T> value_;
+    ParseError error_;
+};
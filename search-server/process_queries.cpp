@@ -10,6 +10,116 @@ std::vector<std::vector<Document>> ProcessQueries(
     return documents_lists;
 }
 
+std::vector<Expected<std::vector<Document>>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    std::vector<std::chrono::nanoseconds>& latencies)
+{
+    std::vector<Expected<std::vector<Document>>> documents_lists(queries.size(), std::vector<Document>{});
+    latencies.resize(queries.size());
+    std::vector<size_t> indexes(queries.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::for_each(std::execution::par, indexes.begin(), indexes.end(),
+                  [&](size_t i)
+                  {
+                      const auto start = std::chrono::steady_clock::now();
+                      documents_lists[i] = search_server.TryFindTopDocuments(queries[i]);
+                      latencies[i] = std::chrono::steady_clock::now() - start;
+                  }
+                 );
+    return documents_lists;
+}
+
+std::vector<std::vector<Document>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    const StopToken& stop_token)
+{
+    std::vector<std::vector<Document>> documents_lists(queries.size());
+    std::vector<std::exception_ptr> errors(queries.size());
+    QueryOptions options;
+    options.stop_token = stop_token;
+    std::vector<size_t> indexes(queries.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::for_each(std::execution::par, indexes.begin(), indexes.end(),
+                  [&](size_t i)
+                  {
+                      if (stop_token.StopRequested()) {
+                          return;
+                      }
+                      try {
+                          documents_lists[i] = search_server.FindTopDocuments(queries[i], options).documents;
+                      } catch (...) {
+                          errors[i] = std::current_exception();
+                      }
+                  }
+                 );
+    stop_token.ThrowIfStopRequested();
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return documents_lists;
+}
+
+std::vector<std::vector<Document>> ProcessQueries(
+    QueryExecutor& executor,
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    QueryPriority priority,
+    size_t chunk_size)
+{
+    std::vector<std::vector<Document>> documents_lists(queries.size());
+    chunk_size = std::max<size_t>(chunk_size, 1);
+    std::vector<std::future<void>> chunks;
+    chunks.reserve((queries.size() + chunk_size - 1) / chunk_size);
+    for (size_t first = 0; first < queries.size(); first += chunk_size) {
+        const size_t last = std::min(queries.size(), first + chunk_size);
+        chunks.push_back(executor.Submit(priority, [&, first, last]() {
+            for (size_t i = first; i < last; ++i) {
+                documents_lists[i] = search_server.FindTopDocuments(queries[i]);
+            }
+        }));
+    }
+    // every chunk is waited for before an error is rethrown, the tasks reference local state
+    std::exception_ptr error;
+    for (auto& chunk : chunks) {
+        try {
+            chunk.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+    return documents_lists;
+}
+
+std::future<std::vector<Document>> FindTopDocumentsAsync(
+    QueryExecutor& executor,
+    const SearchServer& search_server,
+    std::string raw_query,
+    QueryPriority priority)
+{
+    return executor.Submit(priority, [&search_server, raw_query = std::move(raw_query)]() {
+        return search_server.FindTopDocuments(raw_query);
+    });
+}
+
+std::vector<std::vector<CompactDocument>> ProcessQueriesCompact(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries)
+{
+    std::vector<std::vector<CompactDocument>> documents_lists(queries.size());
+    transform(std::execution::par, queries.begin(), queries.end(), documents_lists.begin(),
+              [&](const auto& query) { return search_server.FindTopCompactDocuments(query); });
+    return documents_lists;
+}
+
 std::list<Document> ProcessQueriesJoined(
     const SearchServer& search_server,
     const std::vector<std::string>& queries)
@@ -1,9 +1,46 @@
+#pragma once
 #include <list>
+#include <chrono>
 #include "search_server.h"
+#include "query_executor.h"
 std::vector<std::vector<Document>> ProcessQueries(
     const SearchServer& search_server,
     const std::vector<std::string>& queries); 
 
+// Also reports how long every query took; a malformed query gets its ParseError
+// instead of terminating the parallel loop
+std::vector<Expected<std::vector<Document>>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    std::vector<std::chrono::nanoseconds>& latencies);
+
+// Queries not started by the time stop_token is triggered are skipped, queries in flight
+// stop scoring; throws OperationCancelled if a stop was requested, otherwise rethrows the
+// error of the first malformed query once all queries are done
+std::vector<std::vector<Document>> ProcessQueries(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    const StopToken& stop_token);
+
+// Runs the queries on the executor's queue for priority, chunk_size queries per task
+std::vector<std::vector<Document>> ProcessQueries(
+    QueryExecutor& executor,
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries,
+    QueryPriority priority = QueryPriority::BATCH,
+    size_t chunk_size = 16);
+
+std::future<std::vector<Document>> FindTopDocumentsAsync(
+    QueryExecutor& executor,
+    const SearchServer& search_server,
+    std::string raw_query,
+    QueryPriority priority = QueryPriority::INTERACTIVE);
+
+// Results as 12-byte CompactDocument records
+std::vector<std::vector<CompactDocument>> ProcessQueriesCompact(
+    const SearchServer& search_server,
+    const std::vector<std::string>& queries);
+
 std::list<Document> ProcessQueriesJoined(
     const SearchServer& search_server,
-    const std::vector<std::string>& queries);
\ No newline at end of file
+    const std::vector<std::string>& queries);
@@ -0,0 +1,63 @@
+#include "query_budget.h"
+#include <algorithm>
+
+using namespace std;
+
+QueryOptions QueryOptions::WithTimeBudget(chrono::nanoseconds budget) {
+    QueryOptions options;
+    options.deadline = chrono::steady_clock::now() + budget;
+    return options;
+}
+
+bool QueryOptions::IsLimited() const {
+    return deadline != chrono::steady_clock::time_point::max() || stop_token.StopPossible();
+}
+
+QueryBudget::QueryBudget(const QueryOptions& options)
+    : deadline_(options.deadline)
+    , check_interval_(max<size_t>(options.check_interval, 1))
+    , stop_token_(options.stop_token)
+{
+}
+
+size_t QueryBudget::GetCheckInterval() const {
+    return check_interval_;
+}
+
+bool QueryBudget::IsExhausted() {
+    if (exhausted_.load(memory_order_relaxed)) {
+        return true;
+    }
+    if (stop_token_.StopRequested()) {
+        cancelled_.store(true, memory_order_relaxed);
+    } else if (deadline_ == chrono::steady_clock::time_point::max() || chrono::steady_clock::now() < deadline_) {
+        return false;
+    }
+    exhausted_.store(true, memory_order_relaxed);
+    return true;
+}
+
+void QueryBudget::SkipTerm(size_t posting_count) {
+    skipped_terms_.fetch_add(1, memory_order_relaxed);
+    SkipPostings(posting_count);
+}
+
+void QueryBudget::SkipPostings(size_t posting_count) {
+    skipped_postings_.fetch_add(posting_count, memory_order_relaxed);
+}
+
+bool QueryBudget::IsPartial() const {
+    return skipped_terms_.load(memory_order_relaxed) > 0 || skipped_postings_.load(memory_order_relaxed) > 0;
+}
+
+bool QueryBudget::IsCancelled() const {
+    return cancelled_.load(memory_order_relaxed);
+}
+
+size_t QueryBudget::GetSkippedTerms() const {
+    return skipped_terms_.load(memory_order_relaxed);
+}
+
+size_t QueryBudget::GetSkippedPostings() const {
+    return skipped_postings_.load(memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "document.h"
+#include "stop_token.h"
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+struct QueryOptions {
+    // time_point::max() means no deadline
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    // postings scored between two reads of the clock and the stop token
+    size_t check_interval = 1024;
+    // a stop request ends scoring like an expired deadline
+    StopToken stop_token;
+    // Trades recall for latency: words with a champion list are scored from that many of their
+    // heaviest postings, without proof that the result is the exact top; 0 is exact.
+    // The count is raised to the results requested and capped by
+    // SearchServerOptions::champion_list_size, the postings the lists keep. Words with fewer
+    // than champion_list_min_postings postings have no list and are always scored in full.
+    size_t approximate_postings_per_term = 0;
+    
+    static QueryOptions WithTimeBudget(std::chrono::nanoseconds budget);
+    // A deadline is set or a stop token is attached
+    bool IsLimited() const;
+};
+
+struct SearchResult {
+    std::vector<Document> documents;
+    // set when the deadline cut the postings traversal short, documents are the best
+    // among the postings scored; minus words are always applied in full
+    bool is_partial = false;
+    // plus words whose postings were not read at all
+    size_t skipped_terms = 0;
+    // postings left unscored, those of skipped terms included
+    size_t skipped_postings = 0;
+    // set when the query was stopped through its token
+    bool is_cancelled = false;
+    // set when the documents came from truncated champion lists and may miss some of the top
+    bool is_approximate = false;
+};
+
+// Deadline and stop token of one query, shared by its parallel workers
+class QueryBudget {
+public:
+    explicit QueryBudget(const QueryOptions& options);
+    QueryBudget(const QueryBudget&) = delete;
+    QueryBudget& operator=(const QueryBudget&) = delete;
+    
+    size_t GetCheckInterval() const;
+    // Reads the clock and the token, once the deadline has passed or a stop was requested
+    // the budget stays exhausted
+    bool IsExhausted();
+    void SkipTerm(size_t posting_count);
+    void SkipPostings(size_t posting_count);
+    
+    bool IsPartial() const;
+    bool IsCancelled() const;
+    size_t GetSkippedTerms() const;
+    size_t GetSkippedPostings() const;
+private:
+    std::chrono::steady_clock::time_point deadline_;
+    size_t check_interval_;
+    StopToken stop_token_;
+    std::atomic<bool> exhausted_{false};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<size_t> skipped_terms_{0};
+    std::atomic<size_t> skipped_postings_{0};
+};
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "query_executor.h"
+#include <algorithm>
+
+using namespace std;
+
+QueryExecutor::QueryExecutor(size_t thread_count, SchedulingPolicy policy, size_t interactive_weight)
+    : policy_(policy)
+    , interactive_weight_(max<size_t>(interactive_weight, 1))
+{
+    if (thread_count == 0) {
+        thread_count = max(thread::hardware_concurrency(), 1u);
+    }
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back([this] { RunWorker(); });
+    }
+}
+
+QueryExecutor::~QueryExecutor() {
+    {
+        lock_guard<mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+    for (thread& worker : workers_) {
+        worker.join();
+    }
+}
+
+size_t QueryExecutor::GetThreadCount() const {
+    return workers_.size();
+}
+
+size_t QueryExecutor::GetQueueSize(QueryPriority priority) const {
+    lock_guard<mutex> lock(mutex_);
+    return queues_[static_cast<size_t>(priority)].size();
+}
+
+void QueryExecutor::Enqueue(QueryPriority priority, function<void()> task) {
+    {
+        lock_guard<mutex> lock(mutex_);
+        queues_[static_cast<size_t>(priority)].push_back(move(task));
+    }
+    task_available_.notify_one();
+}
+
+function<void()> QueryExecutor::PopNextTask() {
+    auto& interactive = queues_[static_cast<size_t>(QueryPriority::INTERACTIVE)];
+    auto& batch = queues_[static_cast<size_t>(QueryPriority::BATCH)];
+    const bool batch_turn = policy_ == SchedulingPolicy::WEIGHTED && interactive_streak_ >= interactive_weight_;
+    auto& queue = interactive.empty() || (batch_turn && !batch.empty()) ? batch : interactive;
+    interactive_streak_ = &queue == &interactive ? interactive_streak_ + 1 : 0;
+    function<void()> task = move(queue.front());
+    queue.pop_front();
+    return task;
+}
+
+void QueryExecutor::RunWorker() {
+    for (;;) {
+        function<void()> task;
+        {
+            unique_lock<mutex> lock(mutex_);
+            task_available_.wait(lock, [this] {
+                return stopping_ || any_of(queues_.begin(), queues_.end(), [](const auto& queue) { return !queue.empty(); });
+            });
+            if (all_of(queues_.begin(), queues_.end(), [](const auto& queue) { return queue.empty(); })) {
+                return;
+            }
+            task = PopNextTask();
+        }
+        task();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+#include <array>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <type_traits>
+#include <condition_variable>
+
+enum class QueryPriority {
+    INTERACTIVE,
+    BATCH,
+};
+
+enum class SchedulingPolicy {
+    // batch tasks run only while no interactive task waits
+    STRICT,
+    // after interactive_weight interactive tasks in a row a waiting batch task gets a turn,
+    // so batch work is never starved
+    WEIGHTED,
+};
+
+// Fixed pool of worker threads fed from one queue per priority class. Tasks run to completion,
+// so batch work should be submitted in small chunks for interactive tasks to get through;
+// tasks should use sequential policies, the pool itself provides the parallelism.
+class QueryExecutor {
+public:
+    // thread_count 0 means one thread per hardware thread
+    explicit QueryExecutor(size_t thread_count = 0, SchedulingPolicy policy = SchedulingPolicy::WEIGHTED,
+                           size_t interactive_weight = 4);
+    QueryExecutor(const QueryExecutor&) = delete;
+    QueryExecutor& operator=(const QueryExecutor&) = delete;
+    // Runs the tasks already queued, then joins the workers
+    ~QueryExecutor();
+    
+    template <typename Function>
+    std::future<std::invoke_result_t<Function>> Submit(QueryPriority priority, Function function);
+    
+    size_t GetThreadCount() const;
+    size_t GetQueueSize(QueryPriority priority) const;
+private:
+    static constexpr size_t PRIORITY_COUNT = 2;
+    
+    const SchedulingPolicy policy_;
+    const size_t interactive_weight_;
+    mutable std::mutex mutex_;
+    std::condition_variable task_available_;
+    std::array<std::deque<std::function<void()>>, PRIORITY_COUNT> queues_;
+    size_t interactive_streak_ = 0;
+    bool stopping_ = false;
+    std::vector<std::thread> workers_;
+    
+    void Enqueue(QueryPriority priority, std::function<void()> task);
+    std::function<void()> PopNextTask();
+    void RunWorker();
+};
+
+template <typename Function>
+std::future<std::invoke_result_t<Function>> QueryExecutor::Submit(QueryPriority priority, Function function)
+{
+    // std::function needs a copyable target, the move-only task is shared instead
+    auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Function>()>>(std::move(function));
+    auto result = task->get_future();
+    Enqueue(priority, [task]() { (*task)(); });
+    return result;
+}
\ No newline at end of file
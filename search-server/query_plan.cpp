@@ -0,0 +1,52 @@
+#include "query_plan.h"
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+using namespace std;
+
+namespace {
+void PrintTerms(ostream& out, string_view name, const vector<PlannedTerm>& terms) {
+    out << '\n' << name << ':';
+    for (const PlannedTerm& term : terms) {
+        out << ' ' << term.word << " (postings = "s << term.postings
+            << ", idf = "s << term.inverse_document_freq << ')';
+    }
+}
+}
+
+double EstimateTermAtATimeCost(size_t posting_count, size_t document_count) {
+    const double accumulator_size = static_cast<double>(min(posting_count, document_count));
+    return posting_count * (log2(2.0 + accumulator_size) + log2(2.0 + document_count));
+}
+
+double EstimateDocumentAtATimeCost(size_t posting_count, size_t term_count, size_t document_count) {
+    // every document is merged from at most posting_count cursor positions
+    return posting_count * (static_cast<double>(term_count) + log2(2.0 + document_count));
+}
+
+double EstimateChampionListsCost(size_t candidate_count, size_t term_count, size_t document_count) {
+    return candidate_count * (term_count + 1.0) * log2(2.0 + document_count);
+}
+
+ostream& operator<<(ostream& out, ScoringStrategy strategy) {
+    switch (strategy) {
+        case ScoringStrategy::TERM_AT_A_TIME:
+            return out << "term-at-a-time"s;
+        case ScoringStrategy::DOCUMENT_AT_A_TIME:
+            return out << "document-at-a-time"s;
+    }
+    return out;
+}
+
+ostream& operator<<(ostream& out, const QueryPlan& plan) {
+    out << "strategy = "s << (plan.tries_champion_lists ? "champion lists, then "s : ""s) << plan.strategy
+        << ", estimated postings = "s << plan.estimated_postings
+        << ", cost = { term-at-a-time = "s << plan.term_at_a_time_cost
+        << ", document-at-a-time = "s << plan.document_at_a_time_cost
+        << ", champion lists = "s << plan.champion_lists_cost << " }"s;
+    PrintTerms(out, "minus"sv, plan.minus_terms);
+    PrintTerms(out, "plus"sv, plan.plus_terms);
+    PrintTerms(out, "pruned"sv, plan.pruned_terms);
+    return out;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+enum class ScoringStrategy {
+    // posting lists are scored one after another into a per-document accumulator
+    TERM_AT_A_TIME,
+    // posting lists are merged by document id and each document is scored once
+    DOCUMENT_AT_A_TIME,
+};
+
+struct PlannedTerm {
+    std::string word;
+    size_t postings = 0;
+    double inverse_document_freq = 0.0;
+};
+
+// How FindTopDocuments runs a query, as reported by Explain
+struct QueryPlan {
+    // minus words are applied first, so excluded documents are never scored
+    std::vector<PlannedTerm> minus_terms;
+    // in scoring order, shortest posting list first
+    std::vector<PlannedTerm> plus_terms;
+    // plus words left out: unknown to the index or with a negligible IDF
+    std::vector<PlannedTerm> pruned_terms;
+    ScoringStrategy strategy = ScoringStrategy::TERM_AT_A_TIME;
+    // top-K is first looked for in the champion lists, the strategy is the fallback
+    // when they can't prove the result complete
+    bool tries_champion_lists = false;
+    // postings read, those of minus words included
+    size_t estimated_postings = 0;
+    // the plan takes the cheaper strategy, unless a deadline requires term-at-a-time
+    double term_at_a_time_cost = 0.0;
+    double document_at_a_time_cost = 0.0;
+    double champion_lists_cost = 0.0;
+};
+
+// Cost units of scoring posting_count postings of term_count plus words against an index
+// of document_count documents. Term-at-a-time pays a lookup in the accumulator and in the
+// documents per posting, document-at-a-time a pass over the cursors instead.
+double EstimateTermAtATimeCost(size_t posting_count, size_t document_count);
+double EstimateDocumentAtATimeCost(size_t posting_count, size_t term_count, size_t document_count);
+// Scoring candidate_count candidates by a lookup in the posting list of each plus word
+double EstimateChampionListsCost(size_t candidate_count, size_t term_count, size_t document_count);
+
+std::ostream& operator<<(std::ostream& out, ScoringStrategy strategy);
+std::ostream& operator<<(std::ostream& out, const QueryPlan& plan);
\ No newline at end of file
@@ -0,0 +1,154 @@
+#pragma once
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <execution>
+#include <memory_resource>
+#include <vector>
+
+// Ascending rank keys give the results order: relevance descending, quantized to buckets
+// of width epsilon, then rating descending. Equal keys are ordered by document id ascending,
+// so (key, id) is a total order, unlike comparing relevances within epsilon. Relevances
+// that differ by less than epsilon may still fall into neighbouring buckets.
+using RankKey = uint64_t;
+
+inline RankKey MakeRankKey(double relevance, int rating, double epsilon) {
+    constexpr double lowest = std::numeric_limits<int32_t>::min();
+    constexpr double highest = std::numeric_limits<int32_t>::max();
+    const double bucket = std::clamp(std::floor(relevance / epsilon), lowest, highest);
+    // flipping the sign bit maps signed order onto unsigned order, inverting makes it descending
+    const uint32_t relevance_bits = ~(static_cast<uint32_t>(static_cast<int32_t>(bucket)) ^ 0x80000000u);
+    const uint32_t rating_bits = ~(static_cast<uint32_t>(rating) ^ 0x80000000u);
+    return static_cast<RankKey>(relevance_bits) << 32 | rating_bits;
+}
+
+struct RankedEntry {
+    RankKey key;
+    uint32_t id;
+    // position of the document in the unordered results
+    uint32_t index;
+};
+
+namespace rank_detail {
+
+// 4 id bytes, then 8 key bytes, least significant first
+constexpr size_t DIGIT_COUNT = 12;
+constexpr size_t RADIX = 256;
+constexpr size_t CHUNK_SIZE = 1 << 14;
+using Histogram = std::array<size_t, RADIX>;
+
+inline size_t GetDigit(const RankedEntry& entry, size_t digit) {
+    return digit < 4 ? (entry.id >> (8 * digit)) & 0xFF : (entry.key >> (8 * (digit - 4))) & 0xFF;
+}
+
+// Large inputs are counted in chunks under the policy and the chunk histograms summed
+template <typename ExecutionPolicy>
+Histogram CountDigits(ExecutionPolicy&& policy, const RankedEntry* entries, size_t size, size_t digit,
+                      std::pmr::memory_resource* resource) {
+    Histogram counts{};
+    if (size <= CHUNK_SIZE) {
+        for (size_t i = 0; i < size; ++i) {
+            ++counts[GetDigit(entries[i], digit)];
+        }
+        return counts;
+    }
+    std::pmr::vector<Histogram> chunk_counts((size + CHUNK_SIZE - 1) / CHUNK_SIZE, Histogram{}, resource);
+    std::for_each(policy, chunk_counts.begin(), chunk_counts.end(),
+                  [&](Histogram& chunk) {
+                      const size_t first = (&chunk - chunk_counts.data()) * CHUNK_SIZE;
+                      const size_t last = std::min(size, first + CHUNK_SIZE);
+                      for (size_t i = first; i < last; ++i) {
+                          ++chunk[GetDigit(entries[i], digit)];
+                      }
+                  });
+    for (const Histogram& chunk : chunk_counts) {
+        for (size_t value = 0; value < RADIX; ++value) {
+            counts[value] += chunk[value];
+        }
+    }
+    return counts;
+}
+
+} // namespace rank_detail
+
+// Stable LSD radix sort by (key, id), 8 bits per pass; passes where every entry
+// has the same digit are skipped
+template <typename ExecutionPolicy>
+void RadixSortRanked(ExecutionPolicy&& policy, std::pmr::vector<RankedEntry>& entries) {
+    using namespace rank_detail;
+    std::pmr::memory_resource* resource = entries.get_allocator().resource();
+    std::pmr::vector<RankedEntry> buffer(entries.size(), RankedEntry{}, resource);
+    for (size_t digit = 0; digit < DIGIT_COUNT; ++digit) {
+        const Histogram counts = CountDigits(policy, entries.data(), entries.size(), digit, resource);
+        if (std::find(counts.begin(), counts.end(), entries.size()) != counts.end()) {
+            continue;
+        }
+        Histogram offsets;
+        size_t offset = 0;
+        for (size_t value = 0; value < RADIX; ++value) {
+            offsets[value] = offset;
+            offset += counts[value];
+        }
+        for (const RankedEntry& entry : entries) {
+            buffer[offsets[GetDigit(entry, digit)]++] = entry;
+        }
+        entries.swap(buffer);
+    }
+}
+
+// Keeps the count first entries in (key, id) order, in no particular order. Radix select
+// from the most significant digit: each pass takes the buckets wholly below the count-th
+// entry and narrows the candidates to the bucket containing it.
+template <typename ExecutionPolicy>
+void RadixSelectRanked(ExecutionPolicy&& policy, std::pmr::vector<RankedEntry>& entries, size_t count) {
+    using namespace rank_detail;
+    if (count >= entries.size()) {
+        return;
+    }
+    // entries[0, selected) are in the result, entries[selected, candidates_end) are undecided
+    size_t selected = 0;
+    size_t candidates_end = entries.size();
+    for (size_t digit = DIGIT_COUNT; digit-- > 0 && selected < count;) {
+        const Histogram counts = CountDigits(policy, entries.data() + selected, candidates_end - selected, digit,
+                                             entries.get_allocator().resource());
+        size_t pivot = 0;
+        for (size_t below = selected; below + counts[pivot] <= count; ++pivot) {
+            below += counts[pivot];
+        }
+        const auto first = entries.begin() + selected;
+        const auto last = entries.begin() + candidates_end;
+        const auto pivot_begin = std::partition(policy, first, last, [digit, pivot](const RankedEntry& entry) {
+            return GetDigit(entry, digit) < pivot;
+        });
+        const auto pivot_end = std::partition(policy, pivot_begin, last, [digit, pivot](const RankedEntry& entry) {
+            return GetDigit(entry, digit) == pivot;
+        });
+        selected = pivot_begin - entries.begin();
+        candidates_end = pivot_end - entries.begin();
+    }
+    entries.resize(count);
+}
+
+// Leaves the first min(count, size) documents in results order and drops the rest.
+// Document ids must be non-negative; scratch memory comes from the documents' resource.
+template <typename ExecutionPolicy, typename Result>
+void OrderByRank(ExecutionPolicy&& policy, std::pmr::vector<Result>& documents, size_t count, double epsilon) {
+    std::pmr::vector<RankedEntry> entries(documents.size(), RankedEntry{}, documents.get_allocator().resource());
+    std::transform(policy, documents.begin(), documents.end(), entries.begin(),
+                   [&documents, epsilon](const Result& document) {
+                       return RankedEntry{MakeRankKey(document.relevance, document.rating, epsilon),
+                                          static_cast<uint32_t>(document.id),
+                                          static_cast<uint32_t>(&document - documents.data())};
+                   });
+    RadixSelectRanked(policy, entries, count);
+    RadixSortRanked(policy, entries);
+
+    std::pmr::vector<Result> ordered(documents.get_allocator().resource());
+    ordered.reserve(entries.size());
+    for (const RankedEntry& entry : entries) {
+        ordered.push_back(documents[entry.index]);
+    }
+    documents = std::move(ordered);
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "remove_duplicates.h"
+#include <numeric>
+#include <stdexcept>
+
+using namespace std;
+
+namespace {
+bool HaveSameWords(const SearchServer& search_server, int lhs_id, int rhs_id) {
+    const auto [lhs_first, lhs_last] = search_server.GetWordFrequencies(lhs_id).terms();
+    const auto [rhs_first, rhs_last] = search_server.GetWordFrequencies(rhs_id).terms();
+    return equal(lhs_first, lhs_last, rhs_first, rhs_last,
+                 [](const TermFrequency& l, const TermFrequency& r) { return l.term_id == r.term_id; });
+}
+
+template <typename ExecutionPolicy>
+vector<int> FindDuplicatesImpl(ExecutionPolicy&& policy, const SearchServer& search_server) {
+    // an exception escaping the policy algorithm below would terminate the process
+    if (!search_server.HasForwardIndex()) {
+        throw logic_error("Duplicate search needs the forward index"s);
+    }
+    const vector<int> document_ids(search_server.begin(), search_server.end());
+    vector<pair<WordSetFingerprint, int>> fingerprints(document_ids.size());
+    transform(policy, document_ids.begin(), document_ids.end(), fingerprints.begin(),
+              [&](int document_id) { return pair{search_server.GetWordSetFingerprint(document_id), document_id}; });
+    sort(policy, fingerprints.begin(), fingerprints.end());
+    
+    // groups of equal fingerprints start where the fingerprint changes
+    vector<size_t> indexes(fingerprints.size());
+    iota(indexes.begin(), indexes.end(), 0);
+    vector<size_t> group_starts(fingerprints.size());
+    group_starts.erase(copy_if(policy, indexes.begin(), indexes.end(), group_starts.begin(),
+                               [&fingerprints](size_t i) {
+                                   return i == 0 || !(fingerprints[i].first == fingerprints[i - 1].first);
+                               }),
+                       group_starts.end());
+    group_starts.push_back(fingerprints.size());
+    
+    // within a group ids ascend and a document is a duplicate of the kept one with the same
+    // word set; comparing with every kept document keeps colliding word sets apart
+    vector<vector<int>> group_duplicates(group_starts.size() - 1);
+    indexes.resize(group_duplicates.size());
+    for_each(policy, indexes.begin(), indexes.end(),
+             [&](size_t group) {
+                 vector<int> kept;
+                 for (size_t i = group_starts[group]; i < group_starts[group + 1]; ++i) {
+                     const int document_id = fingerprints[i].second;
+                     if (any_of(kept.begin(), kept.end(), [&](int kept_id) {
+                             return HaveSameWords(search_server, kept_id, document_id);
+                         })) {
+                         group_duplicates[group].push_back(document_id);
+                     } else {
+                         kept.push_back(document_id);
+                     }
+                 }
+             });
+    vector<int> duplicates;
+    for (const vector<int>& documents : group_duplicates) {
+        duplicates.insert(duplicates.end(), documents.begin(), documents.end());
+    }
+    sort(duplicates.begin(), duplicates.end());
+    return duplicates;
+}
+
+template <typename ExecutionPolicy>
+void RemoveDuplicatesImpl(ExecutionPolicy&& policy, SearchServer& search_server) {
+    const vector<int> duplicates = FindDuplicates(policy, search_server);
+    for (const int document_id : duplicates) {
+        cout << "Found duplicate document id "s << document_id << endl;
+    }
+    search_server.RemoveDocuments(policy, duplicates);
+}
+}
+
+vector<int> FindDuplicates(execution::sequenced_policy policy, const SearchServer& search_server) {
+    return FindDuplicatesImpl(policy, search_server);
+}
+
+vector<int> FindDuplicates(execution::parallel_policy policy, const SearchServer& search_server) {
+    return FindDuplicatesImpl(policy, search_server);
+}
+
+vector<int> FindDuplicates(const SearchServer& search_server) {
+    return FindDuplicates(execution::seq, search_server);
+}
+
+void RemoveDuplicates(execution::sequenced_policy policy, SearchServer& search_server) {
+    RemoveDuplicatesImpl(policy, search_server);
+}
+
+void RemoveDuplicates(execution::parallel_policy policy, SearchServer& search_server) {
+    RemoveDuplicatesImpl(policy, search_server);
+}
+
+void RemoveDuplicates(SearchServer& search_server) {
+    RemoveDuplicates(execution::seq, search_server);
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include "search_server.h"
+
+// Ids of documents whose word set repeats one of a document with a smaller id
+std::vector<int> FindDuplicates(std::execution::sequenced_policy, const SearchServer& search_server);
+std::vector<int> FindDuplicates(std::execution::parallel_policy, const SearchServer& search_server);
+std::vector<int> FindDuplicates(const SearchServer& search_server);
+
+void RemoveDuplicates(std::execution::sequenced_policy, SearchServer& search_server);
+void RemoveDuplicates(std::execution::parallel_policy, SearchServer& search_server);
+void RemoveDuplicates(SearchServer& search_server);
@@ -0,0 +1,211 @@
+#include "result_writer.h"
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+ResultWriter::ResultWriter(ostream& out, ResultFormat format, size_t flush_threshold)
+    : out_(out)
+    , format_(format)
+    , flush_threshold_(flush_threshold)
+{
+    buffer_.reserve(flush_threshold_);
+}
+
+ResultWriter::~ResultWriter() {
+    Flush();
+}
+
+void ResultWriter::WriteDocument(const Document& document) {
+    AppendDocument(document);
+    if (format_ != ResultFormat::BINARY) {
+        buffer_ += '\n';
+    }
+    FlushIfFull();
+}
+
+template <typename DocumentContainer>
+void ResultWriter::AppendDocuments(const DocumentContainer& documents) {
+    switch (format_) {
+    case ResultFormat::TEXT:
+        for (const auto& document : documents) {
+            AppendDocument(static_cast<Document>(document));
+            buffer_ += '\n';
+        }
+        break;
+    case ResultFormat::JSON:
+        buffer_ += '[';
+        for (size_t i = 0; i < documents.size(); ++i) {
+            if (i > 0) {
+                buffer_ += ',';
+            }
+            AppendDocument(static_cast<Document>(documents[i]));
+        }
+        buffer_ += "]\n"sv;
+        break;
+    case ResultFormat::BINARY:
+        AppendRaw(static_cast<uint32_t>(documents.size()));
+        for (const auto& document : documents) {
+            AppendDocument(static_cast<Document>(document));
+        }
+        break;
+    }
+}
+
+void ResultWriter::WriteDocuments(const vector<Document>& documents) {
+    AppendDocuments(documents);
+    FlushIfFull();
+}
+
+void ResultWriter::WriteDocuments(const vector<CompactDocument>& documents) {
+    AppendDocuments(documents);
+    FlushIfFull();
+}
+
+void ResultWriter::WriteMatchResult(int document_id, const vector<string_view>& words, DocumentStatus status) {
+    switch (format_) {
+    case ResultFormat::TEXT:
+        buffer_ += "{ document_id = "sv;
+        AppendInt(document_id);
+        buffer_ += ", status = "sv;
+        AppendInt(static_cast<int>(status));
+        buffer_ += ", words ="sv;
+        for (const string_view word : words) {
+            buffer_ += ' ';
+            buffer_ += word;
+        }
+        buffer_ += "}\n"sv;
+        break;
+    case ResultFormat::JSON:
+        buffer_ += "{\"document_id\":"sv;
+        AppendInt(document_id);
+        buffer_ += ",\"status\":"sv;
+        AppendInt(static_cast<int>(status));
+        buffer_ += ",\"words\":["sv;
+        for (size_t i = 0; i < words.size(); ++i) {
+            if (i > 0) {
+                buffer_ += ',';
+            }
+            AppendJsonString(words[i]);
+        }
+        buffer_ += "]}\n"sv;
+        break;
+    case ResultFormat::BINARY:
+        AppendRaw(static_cast<int32_t>(document_id));
+        AppendRaw(static_cast<int32_t>(status));
+        AppendRaw(static_cast<uint32_t>(words.size()));
+        for (const string_view word : words) {
+            AppendRaw(static_cast<uint32_t>(word.size()));
+            buffer_ += word;
+        }
+        break;
+    }
+    FlushIfFull();
+}
+
+void ResultWriter::WriteLine(string_view text) {
+    buffer_ += text;
+    buffer_ += '\n';
+    FlushIfFull();
+}
+
+void ResultWriter::WriteError(string_view message) {
+    switch (format_) {
+    case ResultFormat::TEXT:
+        buffer_ += "Error: "sv;
+        buffer_ += message;
+        buffer_ += '\n';
+        break;
+    case ResultFormat::JSON:
+        buffer_ += "{\"error\":"sv;
+        AppendJsonString(message);
+        buffer_ += "}\n"sv;
+        break;
+    case ResultFormat::BINARY:
+        AppendRaw(numeric_limits<uint32_t>::max());
+        AppendRaw(static_cast<uint32_t>(message.size()));
+        buffer_ += message;
+        break;
+    }
+    FlushIfFull();
+}
+
+void ResultWriter::Flush() {
+    if (!buffer_.empty()) {
+        out_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+    out_.flush();
+}
+
+string_view ResultWriter::GetBuffer() const {
+    return buffer_;
+}
+
+void ResultWriter::AppendInt(int value) {
+    char digits[16];
+    const auto [last, _] = to_chars(begin(digits), end(digits), value);
+    buffer_.append(digits, last);
+}
+
+void ResultWriter::AppendDouble(double value) {
+    // same digits as the default ostream formatting (%g with precision 6)
+    char digits[32];
+    const auto [last, _] = to_chars(begin(digits), end(digits), value, chars_format::general, 6);
+    buffer_.append(digits, last);
+}
+
+void ResultWriter::AppendJsonString(string_view text) {
+    buffer_ += '"';
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            buffer_ += '\\';
+        }
+        buffer_ += c;
+    }
+    buffer_ += '"';
+}
+
+template <typename T>
+void ResultWriter::AppendRaw(T value) {
+    char bytes[sizeof(T)];
+    memcpy(bytes, &value, sizeof(T));
+    buffer_.append(bytes, sizeof(T));
+}
+
+void ResultWriter::AppendDocument(const Document& document) {
+    switch (format_) {
+    case ResultFormat::TEXT:
+        buffer_ += "{ document_id = "sv;
+        AppendInt(document.id);
+        buffer_ += ", relevance = "sv;
+        AppendDouble(document.relevance);
+        buffer_ += ", rating = "sv;
+        AppendInt(document.rating);
+        buffer_ += " }"sv;
+        break;
+    case ResultFormat::JSON:
+        buffer_ += "{\"document_id\":"sv;
+        AppendInt(document.id);
+        buffer_ += ",\"relevance\":"sv;
+        AppendDouble(document.relevance);
+        buffer_ += ",\"rating\":"sv;
+        AppendInt(document.rating);
+        buffer_ += '}';
+        break;
+    case ResultFormat::BINARY:
+        AppendRaw(static_cast<int32_t>(document.id));
+        AppendRaw(document.relevance);
+        AppendRaw(static_cast<int32_t>(document.rating));
+        break;
+    }
+}
+
+void ResultWriter::FlushIfFull() {
+    if (buffer_.size() >= flush_threshold_) {
+        out_.write(buffer_.data(), buffer_.size());
+        buffer_.clear();
+    }
+}
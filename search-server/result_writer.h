@@ -0,0 +1,56 @@
+#pragma once
+#include "document.h"
+#include <string>
+#include <vector>
+#include <iostream>
+#include <string_view>
+
+enum class ResultFormat {
+    TEXT,
+    JSON,
+    BINARY,
+};
+
+// Renders results into a reusable buffer and hands the whole batch to the stream
+// with a single write on Flush() (or when the buffer grows past flush_threshold).
+// TEXT matches PrintDocument/PrintMatchDocumentResult, JSON emits one value per line,
+// BINARY stores fixed-width fields in host byte order:
+//   document:       int32 id, float64 relevance, int32 rating
+//   document batch: uint32 count, documents
+//   error:          uint32 0xFFFFFFFF in place of the count, uint32 length, bytes
+//   match result:   int32 id, int32 status, uint32 word count, (uint32 length, bytes) per word
+class ResultWriter {
+public:
+    explicit ResultWriter(std::ostream& out = std::cout, ResultFormat format = ResultFormat::TEXT,
+                          size_t flush_threshold = 1 << 16);
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+    ~ResultWriter();
+    
+    void WriteDocument(const Document& document);
+    void WriteDocuments(const std::vector<Document>& documents);
+    // Compact documents are widened to Document, the output is the same for both
+    void WriteDocuments(const std::vector<CompactDocument>& documents);
+    void WriteMatchResult(int document_id, const std::vector<std::string_view>& words, DocumentStatus status);
+    void WriteLine(std::string_view text);
+    // Takes the place of a document batch for a query that failed
+    void WriteError(std::string_view message);
+    
+    void Flush();
+    std::string_view GetBuffer() const;
+private:
+    std::ostream& out_;
+    ResultFormat format_;
+    size_t flush_threshold_;
+    std::string buffer_;
+    
+    void AppendInt(int value);
+    void AppendDouble(double value);
+    void AppendJsonString(std::string_view text);
+    template <typename T>
+    void AppendRaw(T value);
+    void AppendDocument(const Document& document);
+    template <typename DocumentContainer>
+    void AppendDocuments(const DocumentContainer& documents);
+    void FlushIfFull();
+};
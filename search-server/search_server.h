@@ -1,42 +1,169 @@
 #pragma once
+#include "arena.h"
 #include "document.h"
+#include "alloc_stats.h"
+#include "parse_error.h"
+#include "query_budget.h"
+#include "query_plan.h"
+#include "term_statistics.h"
+#include "paginator.h"
+#include "rank_key.h"
+#include "execution_cost.h"
 #include "concurrent_map.h"
+#include "term_dictionary.h"
+#include "minhash_index.h"
+#include "word_frequencies_view.h"
 #include "string_processing.h"
+#include "hashing.h"
 #include <map>
 #include <cmath>
 #include <future>
+#include <optional>
+#include <exception>
+#include <memory_resource>
 #include <iterator>
 #include <typeinfo>
+#include <numeric>
+#include <limits>
 #include <algorithm>
 #include <execution>
+#include <type_traits>
 
-const double EPSILON = 1e-6;
+constexpr double EPSILON = 1e-6;
 const int MAX_RESULT_DOCUMENT_COUNT = 5;
 typedef std::tuple<std::vector<std::string_view>, DocumentStatus> matched_documents;
 
-class SearchServer {
+// Results order: rank key ascending (relevance in epsilon buckets descending, then rating
+// descending), then id ascending. A strict weak ordering, the same one OrderByRank sorts by.
+inline bool IsRankedBeforeWithin(const Document& lhs, const Document& rhs, double epsilon) {
+    const RankKey lhs_key = MakeRankKey(lhs.relevance, lhs.rating, epsilon);
+    const RankKey rhs_key = MakeRankKey(rhs.relevance, rhs.rating, epsilon);
+    return lhs_key != rhs_key ? lhs_key < rhs_key : lhs.id < rhs.id;
+}
+
+inline bool IsRankedBefore(const Document& lhs, const Document& rhs) {
+    return IsRankedBeforeWithin(lhs, rhs, EPSILON);
+}
+
+// Position of the last document of a page, the next page starts right after it
+struct SearchCursor {
+    int document_id = 0;
+    double relevance = 0.0;
+    int rating = 0;
+};
+
+struct PageRequest {
+    size_t offset = 0;
+    size_t limit = MAX_RESULT_DOCUMENT_COUNT;
+    std::optional<SearchCursor> search_after = std::nullopt;
+};
+
+struct SearchPage {
+    std::vector<Document> documents;
+    // set when more documents follow this page
+    std::optional<SearchCursor> next_cursor;
+};
+
+struct WordSetFingerprint {
+    uint64_t low = 0;
+    uint64_t high = 0;
+};
+
+inline bool operator==(const WordSetFingerprint& lhs, const WordSetFingerprint& rhs) {
+    return lhs.low == rhs.low && lhs.high == rhs.high;
+}
+
+inline bool operator<(const WordSetFingerprint& lhs, const WordSetFingerprint& rhs) {
+    return std::tie(lhs.high, lhs.low) < std::tie(rhs.high, rhs.low);
+}
+
+struct SearchServerOptions {
+    // Without the forward index GetWordFrequencies and everything built on it
+    // (fingerprints, duplicate search) are unavailable, and removals sweep all posting lists
+    bool keep_forward_index = true;
+    // used by calls with the execution_auto policy
+    ExecutionThresholds execution_thresholds;
+    // Plus words with IDF at or below it are left out of queries, so documents matched only
+    // by them drop out of the results; 0.0 prunes words found in every document, negative keeps all
+    double negligible_inverse_document_freq = -1.0;
+    // Query plus words found in more than this share of the documents are ignored like stop words,
+    // in FindTopDocuments and MatchDocument alike; 1.0 ignores none. The documents are indexed
+    // in full, so the set follows additions and removals.
+    double max_query_document_ratio = 1.0;
+    // Terms with at least champion_list_min_postings postings keep their champion_list_size
+    // highest-weight postings sorted, plus a reserve of about df / champion_list_size more
+    // that absorbs removals. FindTopDocuments answers from them when that provably
+    // gives the exact top documents, which needs a scorer whose TermScore doesn't decrease
+    // with term frequency; a zero size disables the lists.
+    size_t champion_list_size = 64;
+    size_t champion_list_min_postings = 1024;
+};
+
+// Relevance of a document is the sum of TermScore over the plus words it contains
+struct TfIdfScorer {
+    template <typename Score>
+    static Score InverseDocumentFreq(size_t document_count, size_t document_freq) {
+        return static_cast<Score>(std::log(document_count * 1.0 / document_freq));
+    }
+    template <typename Score>
+    static Score TermScore(Score term_freq, Score inverse_document_freq) {
+        return term_freq * inverse_document_freq;
+    }
+};
+
+// Compile-time configuration of BasicSearchServer, deployments derive from it and override members.
+// DocumentId is the stored id type, the API keeps int ids, so it can't be wider than int.
+// Score is the type of posting weights and accumulated relevance, it is converted to double in results.
+struct SearchServerTraits {
+    using DocumentId = int;
+    using Score = double;
+    using Scorer = TfIdfScorer;
+    static constexpr size_t max_result_document_count = MAX_RESULT_DOCUMENT_COUNT;
+    static constexpr double relevance_epsilon = EPSILON;
+    // false compiles the forward index out, SearchServerOptions::keep_forward_index is then ignored
+    static constexpr bool forward_index = true;
+};
+
+template <typename Traits>
+class BasicSearchServer {
 public:
+    using DocumentId = typename Traits::DocumentId;
+    using Score = typename Traits::Score;
+    using Scorer = typename Traits::Scorer;
+    using DocumentIdIterator = typename std::vector<DocumentId>::const_iterator;
+    
+    static_assert(std::is_integral_v<DocumentId> && sizeof(DocumentId) <= sizeof(int),
+                  "DocumentId must be an integer type not wider than int");
+    
     template <typename StringContainer>
-    explicit SearchServer(const StringContainer& stop_words)
+    explicit BasicSearchServer(const StringContainer& stop_words, SearchServerOptions options = {})
         : stop_words_(MakeUniqueNonEmptyStrings(stop_words))  
+        , options_(options)
     {
         if (!all_of(stop_words_.begin(), stop_words_.end(), IsValidWord)) {
             using namespace std::string_literals;
             throw std::invalid_argument("Some of stop words are invalid"s);
         }
     }
-    explicit SearchServer(const std::string& stop_words_text)
-        : SearchServer(std::string_view(stop_words_text))
+    explicit BasicSearchServer(const std::string& stop_words_text, SearchServerOptions options = {})
+        : BasicSearchServer(std::string_view(stop_words_text), options)
     {
     }
-    explicit SearchServer(std::string_view stop_words_text)
-        : SearchServer(SplitIntoWords(static_cast<std::string>(stop_words_text)))
+    explicit BasicSearchServer(std::string_view stop_words_text, SearchServerOptions options = {})
+        : BasicSearchServer(SplitIntoWords(static_cast<std::string>(stop_words_text)), options)
     {
     }
     
     void AddDocument(int document_id, std::string_view document, DocumentStatus status,
                      const std::vector<int>& ratings);
     
+    // Words are split and validated under the policy, nothing is added if any document is invalid.
+    // A stop request throws OperationCancelled, documents indexed by then are removed again.
+    template <typename ExecutionPolicy>
+    void AddDocuments(ExecutionPolicy&& policy, const std::vector<DocumentInput>& documents,
+                      const StopToken& stop_token = StopToken());
+    void AddDocuments(const std::vector<DocumentInput>& documents);
+    
     template <typename DocumentPredicate>
     std::vector<Document> FindTopDocuments(std::string_view raw_query,
                                       DocumentPredicate document_predicate) const;
@@ -54,182 +181,1801 @@ public:
     
     template <typename ExecutionPolicy>
     std::vector<Document> FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query) const;
+    
+    // Query temporaries and the result are allocated from resource only, so a warmed-up
+    // arena serves a query without touching the global heap. The overloads above do the same
+    // with the thread's query arena, rewound after each query, and copy the result out.
+    template <typename DocumentPredicate>
+    std::pmr::vector<Document> FindTopDocumentsWith(std::pmr::memory_resource* resource, std::string_view raw_query,
+                                                DocumentPredicate document_predicate) const;
+    std::pmr::vector<Document> FindTopDocumentsWith(std::pmr::memory_resource* resource, std::string_view raw_query) const;
+    
+    // Stops scoring once options.deadline has passed and returns the best documents found so far
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    SearchResult FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                  DocumentPredicate document_predicate, const QueryOptions& options) const;
+    template <typename ExecutionPolicy>
+    SearchResult FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, const QueryOptions& options) const;
+    SearchResult FindTopDocuments(std::string_view raw_query, const QueryOptions& options) const;
+    
+    // Same results with relevance narrowed to float, for bulk runs that move many results around
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    std::vector<CompactDocument> FindTopCompactDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                         DocumentPredicate document_predicate) const;
+    template <typename ExecutionPolicy>
+    std::vector<CompactDocument> FindTopCompactDocuments(ExecutionPolicy&& policy, std::string_view raw_query) const;
+    std::vector<CompactDocument> FindTopCompactDocuments(std::string_view raw_query) const;
+    
+    // Only offset + limit best documents are ordered, the rest of the matches stay unsorted
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    SearchPage FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                DocumentPredicate document_predicate, const PageRequest& page) const;
+    
+    template <typename ExecutionPolicy>
+    SearchPage FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, const PageRequest& page) const;
+    
+    SearchPage FindTopDocuments(std::string_view raw_query, const PageRequest& page) const;
 
     int GetDocumentCount() const;
     
-    std::set<int>::const_iterator begin() const;
-    std::set<int>::const_iterator end() const;
+    // Document ids are kept sorted in a contiguous array, the iterators are random access
+    DocumentIdIterator begin() const;
+    DocumentIdIterator end() const;
+    
+    // Ids in [lo, hi)
+    IteratorRange<DocumentIdIterator> GetDocumentIdRange(int lo, int hi) const;
+    
+    // Calls function(IteratorRange) for consecutive chunks of at most chunk_size ids
+    template <typename ExecutionPolicy, typename Function>
+    void ForEachDocumentChunk(ExecutionPolicy&& policy, size_t chunk_size, Function function) const;
+    
+    // Without it GetWordFrequencies and everything built on it throw logic_error
+    bool HasForwardIndex() const;
     
-    const std::map<std::string_view, double>& GetWordFrequencies(int document_id) const;
+    // Words in term id order, the view is invalidated by removals and CompactDictionary
+    WordFrequenciesView GetWordFrequencies(int document_id) const;
+    
+    // 128-bit hash of the document's sorted term id set, equal for documents with equal word sets
+    WordSetFingerprint GetWordSetFingerprint(int document_id) const;
+    
+    // Keeps MinHash signatures of added documents; existing documents are indexed immediately,
+    // from their postings when the forward index is off
+    void EnableNearDuplicateDetection(size_t signature_size = 128, size_t band_count = 32);
+    std::vector<std::pair<int, double>> FindNearDuplicates(int document_id, double threshold) const;
+    template <typename ExecutionPolicy>
+    std::vector<std::vector<int>> ClusterNearDuplicates(ExecutionPolicy&& policy, double threshold) const;
+    std::vector<std::vector<int>> ClusterNearDuplicates(double threshold) const;
     
     void RemoveDocument(std::execution::sequenced_policy policy, int document_id);
     void RemoveDocument(std::execution::parallel_policy, int document_id);
     void RemoveDocument(int document_id);
+    void RemoveDocument(AutoExecutionPolicy, int document_id);
+    
+    template <typename ExecutionPolicy>
+    void RemoveDocuments(ExecutionPolicy&& policy, const std::vector<int>& document_ids);
+    void RemoveDocuments(const std::vector<int>& document_ids);
+    void RemoveDocuments(AutoExecutionPolicy, const std::vector<int>& document_ids);
+    
+    // Renumbers live terms densely, dropping slots of terms released by removals
+    void CompactDictionary();
+    size_t GetTermCount() const;
+    
+    // Document frequency of the word, zero for words absent from the index
+    TermStatistics GetTermStatistics(std::string_view word) const;
+    TermStatisticsSummary GetTermStatisticsSummary() const;
+    // At most count terms, by document frequency descending, then by word
+    std::vector<TermStatistics> GetMostFrequentTerms(size_t count) const;
+    // Terms found in more than min_document_ratio of the documents, candidates for the stop
+    // words of the constructor or for SearchServerOptions::max_query_document_ratio
+    std::vector<TermStatistics> SuggestStopWords(double min_document_ratio) const;
     
     matched_documents MatchDocument(std::execution::sequenced_policy policy, std::string_view raw_query,
                                                         int document_id) const;
     matched_documents MatchDocument(std::execution::parallel_policy, std::string_view raw_query,
                                                         int document_id) const;
+    matched_documents MatchDocument(AutoExecutionPolicy, std::string_view raw_query, int document_id) const;
     matched_documents MatchDocument(std::string_view raw_query,
                                                         int document_id) const;
+    // Throws OperationCancelled when a stop is requested before matching completes
+    matched_documents MatchDocument(std::string_view raw_query, int document_id, const StopToken& stop_token) const;
+    
+    // Non-throwing counterparts: malformed queries and unknown ids come back as a ParseError
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    Expected<std::vector<Document>> TryFindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                        DocumentPredicate document_predicate) const;
+    Expected<std::vector<Document>> TryFindTopDocuments(std::string_view raw_query,
+                                                        DocumentStatus status = DocumentStatus::ACTUAL) const;
+    Expected<matched_documents> TryMatchDocument(std::string_view raw_query, int document_id) const;
+    ParseError CheckQuery(std::string_view raw_query) const;
+    
+    // Plan FindTopDocuments runs the query with; malformed queries throw like FindTopDocuments
+    QueryPlan Explain(std::string_view raw_query) const;
 private:
     struct DocumentData {
         int rating;
         DocumentStatus status;
     };
     
-    const std::set<std::string> stop_words_;
-    std::map<std::string, std::map<int, double>> word_to_document_freqs_;
-    std::map<int, std::map<std::string_view, double>> document_to_word_freqs_;
-    std::map<int, DocumentData> documents_;
-    std::set<int> document_ids_;
-    bool IsStopWord(const std::string& word) const;
-    static bool IsValidWord(const std::string& word);
-    std::vector<std::string> SplitIntoWordsNoStop(const std::string& text) const;
+    const std::set<std::string, std::less<>> stop_words_;
+    const SearchServerOptions options_;
+    TermDictionary dictionary_;
+    std::vector<std::map<DocumentId, Score>> term_to_document_freqs_;
+    // Forward index; when Traits compile it out the member is an empty placeholder and
+    // the code touching it is discarded with if constexpr
+    struct NoForwardIndex {
+    };
+    std::conditional_t<Traits::forward_index, std::map<DocumentId, std::vector<TermFrequency>>, NoForwardIndex>
+        document_to_word_freqs_;
+    std::map<DocumentId, DocumentData> documents_;
+    std::vector<DocumentId> document_ids_;
+    std::optional<MinHashIndex> near_duplicates_;
+    const MinHashIndex& GetNearDuplicateIndex() const;
+    
+    struct ChampionPosting {
+        DocumentId document_id;
+        Score term_freq;
+    };
+    struct ChampionList {
+        // term frequency descending, then id ascending; queries read the first champion_list_size,
+        // the rest is a reserve that absorbs removals
+        std::vector<ChampionPosting> postings;
+        // no posting left out of the list has a higher term frequency
+        Score outside_bound{};
+    };
+    // keyed by term id, only frequent terms have a list
+    std::map<int, ChampionList> term_to_champions_;
+    // The reserve grows with the postings, so the O(df) rebuild of a drained list
+    // is paid for by the df / champion_list_size removals that drained it
+    size_t GetChampionListCapacity(size_t posting_count) const;
+    void BuildChampionList(int term_id);
+    void AddToChampionLists(DocumentId document_id, const std::vector<TermFrequency>& term_frequencies);
+    // victims are sorted
+    void RemoveFromChampionLists(const std::vector<int>& term_ids, const std::vector<DocumentId>& victims);
+    
+    // Both return ids of the terms whose posting lists were touched
+    template <typename ExecutionPolicy>
+    std::vector<int> ErasePostingsByForwardIndex(ExecutionPolicy&& policy, const std::vector<DocumentId>& victims);
+    template <typename ExecutionPolicy>
+    std::vector<int> ErasePostingsBySweep(ExecutionPolicy&& policy, const std::vector<DocumentId>& victims);
+    // False for ids that don't fit DocumentId as well
+    bool HasDocument(int document_id) const;
+    static bool FitsDocumentId(int document_id);
+    bool IsStopWord(std::string_view word) const;
+    bool IsQueryStopWord(std::string_view word) const;
+    TermStatistics MakeTermStatistics(int term_id) const;
+    template <typename TermFilter>
+    std::vector<TermStatistics> CollectTermStatistics(TermFilter term_filter) const;
+    static bool IsValidWord(std::string_view word);
+    ParseError TrySplitIntoWordsNoStop(std::string_view text, std::vector<std::string>& words) const;
+    std::vector<std::string> SplitIntoWordsNoStop(std::string_view text) const;
     static int ComputeAverageRating(const std::vector<int>& ratings);
+    void CheckNewDocumentId(int document_id) const;
+    // Leaves document_ids_ to the caller, batches merge their ids once
+    void IndexDocument(DocumentId document_id, const std::vector<std::string>& words, DocumentStatus status,
+                       const std::vector<int>& ratings);
     
     struct QueryWord {
-        std::string data;
+        std::string_view data;
         bool is_minus;
         bool is_stop;
     };
     
-    QueryWord ParseQueryWord(const std::string& text) const;
+    ParseError ParseQueryWord(std::string_view text, size_t position, QueryWord& query_word) const;
     
+    // Words are views into the raw query text
     struct Query {
-        std::vector<std::string> plus_words;
-        std::vector<std::string> minus_words;
+        explicit Query(std::pmr::memory_resource* resource)
+            : plus_words(resource)
+            , minus_words(resource) {
+        }
+        std::pmr::vector<std::string_view> plus_words;
+        std::pmr::vector<std::string_view> minus_words;
+    };
+    
+    ParseError TryParseQuery(std::string_view text, bool is_parallel, Query& result) const;
+    Query ParseQuery(std::string_view text, bool is_parallel=false,
+                     std::pmr::memory_resource* resource=std::pmr::get_default_resource()) const;
+    matched_documents MatchParsedQuery(const Query& query, int document_id) const;
+    matched_documents MatchParsedQuery(std::execution::parallel_policy, const Query& query, int document_id) const;
+    
+    // Term ids of a query in execution order, words absent from the index are dropped
+    struct PlannedQuery {
+        explicit PlannedQuery(std::pmr::memory_resource* resource)
+            : minus_terms(resource)
+            , plus_terms(resource)
+            , pruned_terms(resource) {
+        }
+        std::pmr::vector<int> minus_terms;
+        std::pmr::vector<int> plus_terms;
+        std::pmr::vector<int> pruned_terms;
+        ScoringStrategy strategy = ScoringStrategy::TERM_AT_A_TIME;
+        // some plus word has a champion list
+        bool has_champion_lists = false;
+        bool tries_champion_lists = false;
+        size_t minus_postings = 0;
+        size_t plus_postings = 0;
+        double term_at_a_time_cost = 0.0;
+        double document_at_a_time_cost = 0.0;
+        double champion_lists_cost = 0.0;
     };
     
-    Query ParseQuery(const std::string& text, bool is_parallel=false) const;
+    // Partial results are accounted term by term, so a budgeted query is always term-at-a-time
+    // and never tries the champion lists
+    PlannedQuery PlanQuery(const Query& query, std::pmr::memory_resource* resource, bool is_budgeted) const;
+    // Sorted ids of the documents containing any minus word
+    std::pmr::vector<DocumentId> CollectExcludedDocuments(const PlannedQuery& plan,
+                                                          std::pmr::memory_resource* resource) const;
+    PlannedTerm DescribeTerm(int term_id) const;
     
-    double ComputeWordInverseDocumentFreq(const std::string& word) const;
+    Score ComputeWordInverseDocumentFreq(int term_id) const;
+    const std::map<DocumentId, Score>* FindPostings(std::string_view word) const;
     
-    template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(const Query& query,
-                                           DocumentPredicate document_predicate) const;
+    // Result is Document or CompactDocument; budget is optional
+    template <typename Result = Document, typename DocumentPredicate, typename ExecutionPolicy>
+    std::pmr::vector<Result> FindTopDocumentsIn(ExecutionPolicy&& policy, std::pmr::memory_resource* resource,
+                                                const Query& query, DocumentPredicate document_predicate,
+                                                QueryBudget* budget = nullptr) const;
     
-    template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(std::execution::sequenced_policy, const Query& query,
-                                           DocumentPredicate document_predicate) const;
+    template <typename DocumentPredicate, typename ExecutionPolicy>
+    SearchPage FindPageIn(ExecutionPolicy&& policy, std::pmr::memory_resource* resource, const Query& query,
+                          DocumentPredicate document_predicate, const PageRequest& page) const;
     
-    template <typename DocumentPredicate>
-    std::vector<Document> FindAllDocuments(std::execution::parallel_policy, const Query& query,
-                                           DocumentPredicate document_predicate) const;
+    // Cost estimates behind the execution_auto policy
+    bool PreferParallelQuery(const Query& query) const;
+    bool PreferParallelRemoval(const std::vector<int>& document_ids) const;
+    
+    // The plan comes from PlanQuery with is_budgeted set when budget is given
+    template <typename Result = Document, typename DocumentPredicate>
+    std::pmr::vector<Result> FindAllDocuments(std::execution::sequenced_policy, const PlannedQuery& plan,
+                                              DocumentPredicate document_predicate,
+                                              std::pmr::memory_resource* resource, QueryBudget* budget = nullptr) const;
+    
+    // The relevance map lives on the global heap, parallel workers can't share the caller's arena
+    template <typename Result = Document, typename DocumentPredicate>
+    std::pmr::vector<Result> FindAllDocuments(std::execution::parallel_policy, const PlannedQuery& plan,
+                                              DocumentPredicate document_predicate,
+                                              std::pmr::memory_resource* resource, QueryBudget* budget = nullptr) const;
+    
+    // Top count documents scored from the first champions_per_term entries of the champion lists
+    // and from the posting lists of words without one; nullopt when fewer documents match.
+    // is_complete tells whether no document outside of them can rank among the top count.
+    template <typename Result, typename DocumentPredicate>
+    std::optional<std::pmr::vector<Result>> FindTopByChampions(const PlannedQuery& plan, DocumentPredicate& document_predicate,
+                                                               size_t count, size_t champions_per_term,
+                                                               std::pmr::memory_resource* resource, bool& is_complete) const;
+    
+    // Merges the plus words' posting lists, documents come out in id order
+    template <typename Result, typename DocumentPredicate>
+    std::pmr::vector<Result> ScoreDocumentAtATime(const PlannedQuery& plan,
+                                                  const std::pmr::vector<DocumentId>& excluded_documents,
+                                                  DocumentPredicate& document_predicate,
+                                                  std::pmr::memory_resource* resource) const;
+    
+    // Calls accumulate(document_id, score) for the term's postings accepted by the predicate.
+    // With a budget the clock is read every check interval postings, and once it has run out
+    // the rest of the postings are counted as skipped.
+    template <typename DocumentPredicate, typename Accumulate>
+    void ScoreTerm(int term_id, DocumentPredicate& document_predicate, QueryBudget* budget,
+                   Accumulate accumulate) const;
 };
 
 
 
-template <typename DocumentPredicate>
-    std::vector<Document> SearchServer::FindAllDocuments(std::execution::sequenced_policy, const Query& query,
-                                           DocumentPredicate document_predicate) const
-{
-    std::map<int, double> document_to_relevance;
-        for (const std::string& word : query.plus_words) {
-            if (word_to_document_freqs_.count(word) != 0) {
-                const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                    const auto& document_data = documents_.at(document_id);
-                    if (document_predicate(document_id, document_data.status, document_data.rating)) {
-                        document_to_relevance[document_id] += term_freq * inverse_document_freq;
-                    }
-                }
-            }
+template <typename Traits>
+template <typename DocumentPredicate, typename Accumulate>
+void BasicSearchServer<Traits>::ScoreTerm(int term_id, DocumentPredicate& document_predicate, QueryBudget* budget,
+                                          Accumulate accumulate) const
+{
+    const auto& postings = term_to_document_freqs_[term_id];
+    if (budget != nullptr && budget->IsExhausted()) {
+        budget->SkipTerm(postings.size());
+        return;
+    }
+    const Score inverse_document_freq = ComputeWordInverseDocumentFreq(term_id);
+    size_t scored = 0;
+    for (const auto [document_id, term_freq] : postings) {
+        if (budget != nullptr && ++scored % budget->GetCheckInterval() == 0 && budget->IsExhausted()) {
+            budget->SkipPostings(postings.size() - scored + 1);
+            return;
         }
-        for (const std::string& word : query.minus_words) {
-            if (word_to_document_freqs_.count(word) != 0) {
-                for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-                    document_to_relevance.erase(document_id);
-                }
-            }
+        const auto& document_data = documents_.at(document_id);
+        if (document_predicate(document_id, document_data.status, document_data.rating)) {
+            accumulate(document_id, Scorer::TermScore(term_freq, inverse_document_freq));
         }
-        std::vector<Document> matched_documents;
+    }
+}
+
+template <typename Traits>
+template <typename Result, typename DocumentPredicate>
+    std::pmr::vector<Result> BasicSearchServer<Traits>::FindAllDocuments(std::execution::sequenced_policy, const PlannedQuery& plan,
+                                           DocumentPredicate document_predicate,
+                                           std::pmr::memory_resource* resource, QueryBudget* budget) const
+{
+    const auto excluded_documents = CollectExcludedDocuments(plan, resource);
+    if (plan.strategy == ScoringStrategy::DOCUMENT_AT_A_TIME) {
+        return ScoreDocumentAtATime<Result>(plan, excluded_documents, document_predicate, resource);
+    }
+    auto is_accepted = [&](DocumentId document_id, DocumentStatus status, int rating) {
+        return !std::binary_search(excluded_documents.begin(), excluded_documents.end(), document_id)
+            && document_predicate(document_id, status, rating);
+    };
+    std::pmr::map<DocumentId, Score> document_to_relevance(resource);
+        for (const int term_id : plan.plus_terms) {
+            ScoreTerm(term_id, is_accepted, budget, [&](DocumentId document_id, Score score) {
+                document_to_relevance[document_id] += score;
+            });
+        }
+        std::pmr::vector<Result> matched_documents(resource);
+        matched_documents.reserve(document_to_relevance.size());
         for (const auto [document_id, relevance] : document_to_relevance) {
-            matched_documents.push_back(
-                {document_id, relevance, documents_.at(document_id).rating});
+            matched_documents.emplace_back(document_id, static_cast<double>(relevance),
+                                           documents_.at(document_id).rating);
         }
         return matched_documents;
 }
 
-template <typename DocumentPredicate>
-std::vector<Document> SearchServer::FindAllDocuments(std::execution::parallel_policy, const Query& query,
-                                           DocumentPredicate document_predicate) const {
+template <typename Traits>
+template <typename Result, typename DocumentPredicate>
+std::pmr::vector<Result> BasicSearchServer<Traits>::FindAllDocuments(std::execution::parallel_policy, const PlannedQuery& plan,
+                                           DocumentPredicate document_predicate,
+                                           std::pmr::memory_resource* resource, QueryBudget* budget) const {
     const int buckets=100;
-    ConcurrentMap<int, double> document_to_relevance(buckets);
+    ConcurrentMap<DocumentId, Score> document_to_relevance(buckets);
+    // the parallel path is term-at-a-time whatever the plan says, it splits the work by word
+    const auto excluded_documents = CollectExcludedDocuments(plan, resource);
+    auto is_accepted = [&](DocumentId document_id, DocumentStatus status, int rating) {
+        return !std::binary_search(excluded_documents.begin(), excluded_documents.end(), document_id)
+            && document_predicate(document_id, status, rating);
+    };
 
-    std::for_each(std::execution::par, query.plus_words.begin(), query.plus_words.end(), 
-                  [&](const std::string& word)
+    std::for_each(std::execution::par, plan.plus_terms.begin(), plan.plus_terms.end(), 
+                  [&](int term_id)
                   {
-                      if (word_to_document_freqs_.count(word) != 0) {
-                          const double inverse_document_freq = ComputeWordInverseDocumentFreq(word);
-                          for (const auto [document_id, term_freq] : word_to_document_freqs_.at(word)) {
-                              const auto& document_data = documents_.at(document_id);
-                              if (document_predicate(document_id, document_data.status, document_data.rating)) {
-                                  document_to_relevance[document_id].ref_to_value += term_freq * inverse_document_freq;
-                              }
-                          }
-                      }  
+                      ScoreTerm(term_id, is_accepted, budget, [&](DocumentId document_id, Score score) {
+                          document_to_relevance[document_id].ref_to_value += score;
+                      });
                   }
                  );
 
-    std::for_each(std::execution::par, query.minus_words.begin(), query.minus_words.end(), 
-                  [&](const std::string& word)
+    std::pmr::vector<Result> matched_documents(resource);
+    const std::map<DocumentId, Score>& result=document_to_relevance.BuildOrdinaryMap();
+    matched_documents.reserve(result.size());
+
+    for (const auto [document_id, relevance] : result) {
+        matched_documents.emplace_back(document_id, static_cast<double>(relevance),
+                                       documents_.at(document_id).rating);
+    }
+
+    return matched_documents;
+}
+
+template <typename Traits>
+template <typename Result, typename DocumentPredicate>
+std::optional<std::pmr::vector<Result>> BasicSearchServer<Traits>::FindTopByChampions(const PlannedQuery& plan,
+                                                                                      DocumentPredicate& document_predicate,
+                                                                                      size_t count, size_t champions_per_term,
+                                                                                      std::pmr::memory_resource* resource,
+                                                                                      bool& is_complete) const {
+    std::pmr::vector<DocumentId> candidates(resource);
+    // relevance of a document found in none of the candidate lists can't exceed it
+    Score outside_bound{};
+    for (const int term_id : plan.plus_terms) {
+        if (const auto champions = term_to_champions_.find(term_id); champions != term_to_champions_.end()) {
+            const auto& postings = champions->second.postings;
+            const size_t used = std::min(champions_per_term, postings.size());
+            for (size_t i = 0; i < used; ++i) {
+                candidates.push_back(postings[i].document_id);
+            }
+            const Score term_bound = used < postings.size()
+                ? std::max(champions->second.outside_bound, postings[used].term_freq)
+                : champions->second.outside_bound;
+            outside_bound += Scorer::TermScore(term_bound, ComputeWordInverseDocumentFreq(term_id));
+        } else {
+            for (const auto [document_id, _] : term_to_document_freqs_[term_id]) {
+                candidates.push_back(document_id);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    
+    const auto excluded_documents = CollectExcludedDocuments(plan, resource);
+    std::pmr::vector<Result> matched_documents(resource);
+    for (const DocumentId document_id : candidates) {
+        if (std::binary_search(excluded_documents.begin(), excluded_documents.end(), document_id)) {
+            continue;
+        }
+        const auto& document_data = documents_.at(document_id);
+        if (!document_predicate(document_id, document_data.status, document_data.rating)) {
+            continue;
+        }
+        // summed in plan order, as the full scoring does
+        Score relevance{};
+        for (const int term_id : plan.plus_terms) {
+            const auto& postings = term_to_document_freqs_[term_id];
+            if (const auto posting = postings.find(document_id); posting != postings.end()) {
+                relevance += Scorer::TermScore(posting->second, ComputeWordInverseDocumentFreq(term_id));
+            }
+        }
+        matched_documents.emplace_back(document_id, static_cast<double>(relevance), document_data.rating);
+    }
+    if (matched_documents.size() < count) {
+        return std::nullopt;
+    }
+    OrderByRank(std::execution::seq, matched_documents, count, Traits::relevance_epsilon);
+    // outside documents rank at best in the bucket above the bound, the margin absorbs rounding
+    const RankKey outside_key = MakeRankKey(static_cast<double>(outside_bound) + Traits::relevance_epsilon,
+                                            std::numeric_limits<int>::max(), Traits::relevance_epsilon);
+    const Result& last = matched_documents.back();
+    is_complete = MakeRankKey(last.relevance, last.rating, Traits::relevance_epsilon) < outside_key;
+    return matched_documents;
+}
+
+template <typename Traits>
+template <typename Result, typename DocumentPredicate>
+std::pmr::vector<Result> BasicSearchServer<Traits>::ScoreDocumentAtATime(const PlannedQuery& plan,
+                                                                         const std::pmr::vector<DocumentId>& excluded_documents,
+                                                                         DocumentPredicate& document_predicate,
+                                                                         std::pmr::memory_resource* resource) const {
+    struct Cursor {
+        typename std::map<DocumentId, Score>::const_iterator position;
+        typename std::map<DocumentId, Score>::const_iterator end;
+        Score inverse_document_freq;
+    };
+    std::pmr::vector<Cursor> cursors(resource);
+    cursors.reserve(plan.plus_terms.size());
+    for (const int term_id : plan.plus_terms) {
+        const auto& postings = term_to_document_freqs_[term_id];
+        cursors.push_back({postings.begin(), postings.end(), ComputeWordInverseDocumentFreq(term_id)});
+    }
+    
+    std::pmr::vector<Result> matched_documents(resource);
+    auto excluded = excluded_documents.begin();
+    while (!cursors.empty()) {
+        DocumentId document_id = cursors.front().position->first;
+        for (const Cursor& cursor : cursors) {
+            document_id = std::min(document_id, cursor.position->first);
+        }
+        // summed in plan order, as term-at-a-time does
+        Score relevance{};
+        for (Cursor& cursor : cursors) {
+            if (cursor.position->first == document_id) {
+                relevance += Scorer::TermScore(cursor.position->second, cursor.inverse_document_freq);
+                ++cursor.position;
+            }
+        }
+        cursors.erase(std::remove_if(cursors.begin(), cursors.end(), [](const Cursor& cursor) {
+                          return cursor.position == cursor.end;
+                      }),
+                      cursors.end());
+        
+        excluded = std::lower_bound(excluded, excluded_documents.end(), document_id);
+        if (excluded != excluded_documents.end() && *excluded == document_id) {
+            continue;
+        }
+        const auto& document_data = documents_.at(document_id);
+        if (document_predicate(document_id, document_data.status, document_data.rating)) {
+            matched_documents.emplace_back(document_id, static_cast<double>(relevance), document_data.rating);
+        }
+    }
+    return matched_documents;
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+void BasicSearchServer<Traits>::AddDocuments(ExecutionPolicy&& policy, const std::vector<DocumentInput>& documents,
+                                             const StopToken& stop_token)
+{
+    std::vector<std::vector<std::string>> words(documents.size());
+    std::vector<std::exception_ptr> errors(documents.size());
+    std::vector<size_t> indexes(documents.size());
+    std::iota(indexes.begin(), indexes.end(), 0);
+    std::for_each(policy, indexes.begin(), indexes.end(),
+                  [&](size_t i)
                   {
-                      if (word_to_document_freqs_.count(word) != 0) {
-                          for (const auto [document_id, _] : word_to_document_freqs_.at(word)) {
-                              document_to_relevance.Erase(document_id);
-                          }
-                      }      
+                      if (stop_token.StopRequested()) {
+                          return;
+                      }
+                      try {
+                          words[i] = SplitIntoWordsNoStop(documents[i].text);
+                      } catch (...) {
+                          errors[i] = std::current_exception();
+                      }
+                  }
+                 );
+    
+    stop_token.ThrowIfStopRequested();
+    std::vector<int> new_ids;
+    new_ids.reserve(documents.size());
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+        CheckNewDocumentId(documents[i].id);
+        new_ids.push_back(documents[i].id);
+    }
+    std::sort(new_ids.begin(), new_ids.end());
+    if (std::adjacent_find(new_ids.begin(), new_ids.end()) != new_ids.end()) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Invalid document_id"s);
+    }
+    
+    // the dictionary and posting lists are filled sequentially
+    const size_t stop_check_interval = 256;
+    for (size_t i = 0; i < documents.size(); ++i) {
+        if (i % stop_check_interval == 0 && stop_token.StopRequested()) {
+            std::vector<int> indexed_ids;
+            for (size_t j = 0; j < i; ++j) {
+                indexed_ids.push_back(documents[j].id);
+            }
+            RemoveDocuments(std::execution::seq, indexed_ids);
+            throw OperationCancelled();
+        }
+        IndexDocument(static_cast<DocumentId>(documents[i].id), words[i], documents[i].status, documents[i].ratings);
+    }
+    // merged once per batch, inserting ids one by one is quadratic for out-of-order input
+    const size_t old_size = document_ids_.size();
+    document_ids_.insert(document_ids_.end(), new_ids.begin(), new_ids.end());
+    std::inplace_merge(document_ids_.begin(), document_ids_.begin() + old_size, document_ids_.end());
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+std::vector<int> BasicSearchServer<Traits>::ErasePostingsByForwardIndex(ExecutionPolicy&& policy,
+                                                                        const std::vector<DocumentId>& victims)
+{
+    // (term, document) pairs of all victims, grouped by term so that every posting list
+    // is touched by exactly one task and the outer map is only read concurrently
+    std::vector<std::pair<int, DocumentId>> term_documents;
+    for (const DocumentId document_id : victims) {
+        const auto [first, last] = GetWordFrequencies(document_id).terms();
+        for (auto it = first; it != last; ++it) {
+            term_documents.emplace_back(it->term_id, document_id);
+        }
+    }
+    std::sort(policy, term_documents.begin(), term_documents.end());
+    
+    std::vector<int> term_ids;
+    std::vector<DocumentId> documents;
+    std::vector<size_t> term_groups;
+    documents.reserve(term_documents.size());
+    for (const auto& [term_id, document_id] : term_documents) {
+        if (term_ids.empty() || term_ids.back() != term_id) {
+            term_ids.push_back(term_id);
+            term_groups.push_back(documents.size());
+        }
+        documents.push_back(document_id);
+    }
+    term_groups.push_back(documents.size());
+    
+    std::vector<size_t> group_indexes(term_ids.size());
+    std::iota(group_indexes.begin(), group_indexes.end(), 0);
+    std::for_each(policy, group_indexes.begin(), group_indexes.end(),
+                  [&](size_t group)
+                  {
+                      auto& postings = term_to_document_freqs_[term_ids[group]];
+                      for (size_t i = term_groups[group]; i < term_groups[group + 1]; ++i) {
+                          postings.erase(documents[i]);
+                      }
                   }
                  );
+    return term_ids;
+}
 
-    std::vector<Document> matched_documents;
-    const std::map<int, double>& result=document_to_relevance.BuildOrdinaryMap();
+template <typename Traits>
+template <typename ExecutionPolicy>
+std::vector<int> BasicSearchServer<Traits>::ErasePostingsBySweep(ExecutionPolicy&& policy,
+                                                                 const std::vector<DocumentId>& victims)
+{
+    // without a forward index every posting list is swept once for the whole batch
+    std::vector<int> term_ids;
+    for (int term_id = 0; term_id < static_cast<int>(term_to_document_freqs_.size()); ++term_id) {
+        if (!term_to_document_freqs_[term_id].empty()) {
+            term_ids.push_back(term_id);
+        }
+    }
+    std::for_each(policy, term_ids.begin(), term_ids.end(),
+                  [&](int term_id)
+                  {
+                      auto& postings = term_to_document_freqs_[term_id];
+                      if (postings.size() < victims.size()) {
+                          for (auto it = postings.begin(); it != postings.end();) {
+                              it = std::binary_search(victims.begin(), victims.end(), it->first)
+                                  ? postings.erase(it) : std::next(it);
+                          }
+                      } else {
+                          for (const DocumentId document_id : victims) {
+                              postings.erase(document_id);
+                          }
+                      }
+                  }
+                 );
+    return term_ids;
+}
 
-    for (const auto [document_id, relevance] : result) {
-        matched_documents.push_back(
-            {document_id, relevance, documents_.at(document_id).rating});
+template <typename Traits>
+template <typename ExecutionPolicy>
+void BasicSearchServer<Traits>::RemoveDocuments(ExecutionPolicy&& policy, const std::vector<int>& document_ids)
+{
+    const AllocationProbe probe(HotPath::REMOVE_DOCUMENT);
+    std::vector<DocumentId> victims;
+    for (const int document_id : document_ids) {
+        if (HasDocument(document_id)) {
+            victims.push_back(static_cast<DocumentId>(document_id));
+        }
+    }
+    std::sort(victims.begin(), victims.end());
+    victims.erase(std::unique(victims.begin(), victims.end()), victims.end());
+    
+    const std::vector<int> term_ids = HasForwardIndex()
+        ? ErasePostingsByForwardIndex(policy, victims)
+        : ErasePostingsBySweep(policy, victims);
+    
+    RemoveFromChampionLists(term_ids, victims);
+    // terms left without postings are reclaimed sequentially, the dictionary is not thread-safe
+    for (const int term_id : term_ids) {
+        if (term_to_document_freqs_[term_id].empty()) {
+            dictionary_.Release(term_id);
+        }
+    }
+    
+    for (const DocumentId document_id : victims) {
+        if (near_duplicates_) {
+            near_duplicates_->RemoveDocument(document_id);
+        }
+        if constexpr (Traits::forward_index) {
+            document_to_word_freqs_.erase(document_id);
+        }
+        documents_.erase(document_id);
+    }
+    
+    // a few victims are erased by shifting the tail, a large batch compacts the ids in one pass
+    const size_t tail_shift_limit = 32;
+    if (victims.size() <= tail_shift_limit) {
+        for (auto victim = victims.rbegin(); victim != victims.rend(); ++victim) {
+            const auto position = std::lower_bound(document_ids_.begin(), document_ids_.end(), *victim);
+            if (position != document_ids_.end() && *position == *victim) {
+                document_ids_.erase(position);
+            }
+        }
+    } else {
+        const auto first = std::lower_bound(document_ids_.begin(), document_ids_.end(), victims.front());
+        document_ids_.erase(std::remove_if(first, document_ids_.end(), [&victims](DocumentId document_id) {
+                                return std::binary_search(victims.begin(), victims.end(), document_id);
+                            }),
+                            document_ids_.end());
     }
+}
 
-    return matched_documents;
+template <typename Traits>
+template <typename ExecutionPolicy, typename Function>
+void BasicSearchServer<Traits>::ForEachDocumentChunk(ExecutionPolicy&& policy, size_t chunk_size, Function function) const
+{
+    const auto chunks = Paginate(document_ids_, std::max<size_t>(chunk_size, 1));
+    std::for_each(policy, chunks.begin(), chunks.end(), function);
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+std::vector<std::vector<int>> BasicSearchServer<Traits>::ClusterNearDuplicates(ExecutionPolicy&& policy, double threshold) const
+{
+    return GetNearDuplicateIndex().ClusterNearDuplicates(policy, threshold);
 }
 
+template <typename Traits>
 template <typename DocumentPredicate>
-std::vector<Document> SearchServer::FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate) const
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(std::string_view raw_query, DocumentPredicate document_predicate) const
 {
     return FindTopDocuments(std::execution::seq, raw_query, document_predicate);
 }
 
+template <typename Traits>
 template <typename DocumentPredicate, typename ExecutionPolicy>
-std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
                                                          DocumentPredicate document_predicate) const {
-    const auto query = ParseQuery(static_cast<std::string>(raw_query), true);
-    auto matched_documents = FindAllDocuments(policy, query, document_predicate);
-    sort(policy, matched_documents.begin(), matched_documents.end(),
-         [](const Document& lhs, const Document& rhs) {
-             return lhs.relevance > rhs.relevance
-                 || (std::abs(lhs.relevance - rhs.relevance) < EPSILON && lhs.rating > rhs.rating);
-         });
-    if (matched_documents.size() > MAX_RESULT_DOCUMENT_COUNT) {
-        matched_documents.resize(MAX_RESULT_DOCUMENT_COUNT);
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto top_documents = FindTopDocumentsIn(policy, &arena, ParseQuery(raw_query, true, &arena), document_predicate);
+    return {top_documents.begin(), top_documents.end()};
+}
+
+template <typename Traits>
+template <typename DocumentPredicate, typename ExecutionPolicy>
+SearchResult BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                         DocumentPredicate document_predicate,
+                                                         const QueryOptions& options) const {
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    QueryBudget budget(options);
+    const auto query = ParseQuery(raw_query, true, &arena);
+    SearchResult result;
+    if (options.approximate_postings_per_term > 0) {
+        // champion scoring is bounded by the truncation, it runs outside the deadline
+        bool is_complete = false;
+        const PlannedQuery plan = PlanQuery(query, &arena, false);
+        if (plan.has_champion_lists) {
+            if (const auto top_documents = FindTopByChampions<Document>(plan, document_predicate,
+                                                                        Traits::max_result_document_count,
+                                                                        std::min(std::max(options.approximate_postings_per_term,
+                                                                                          Traits::max_result_document_count),
+                                                                                 options_.champion_list_size),
+                                                                        &arena, is_complete)) {
+                result.documents.assign(top_documents->begin(), top_documents->end());
+                result.is_approximate = !is_complete;
+                return result;
+            }
+        }
     }
-    return matched_documents;
+    // without limits the query runs like the overloads without options, free to pick any plan
+    const auto top_documents = FindTopDocumentsIn(policy, &arena, query, document_predicate,
+                                                  options.IsLimited() ? &budget : nullptr);
+    result.documents.assign(top_documents.begin(), top_documents.end());
+    result.is_partial = budget.IsPartial();
+    result.skipped_terms = budget.GetSkippedTerms();
+    result.skipped_postings = budget.GetSkippedPostings();
+    result.is_cancelled = budget.IsCancelled();
+    return result;
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+SearchResult BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                         const QueryOptions& options) const {
+    return FindTopDocuments(policy, raw_query, [](int, DocumentStatus document_status, int) {
+            return document_status == DocumentStatus::ACTUAL;
+        }, options);
+}
+
+template <typename Traits>
+template <typename DocumentPredicate, typename ExecutionPolicy>
+std::vector<CompactDocument> BasicSearchServer<Traits>::FindTopCompactDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                                                DocumentPredicate document_predicate) const {
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto top_documents = FindTopDocumentsIn<CompactDocument>(policy, &arena, ParseQuery(raw_query, true, &arena),
+                                                                   document_predicate);
+    return {top_documents.begin(), top_documents.end()};
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+std::vector<CompactDocument> BasicSearchServer<Traits>::FindTopCompactDocuments(ExecutionPolicy&& policy,
+                                                                                std::string_view raw_query) const {
+    return FindTopCompactDocuments(policy, raw_query, [](int, DocumentStatus document_status, int) {
+            return document_status == DocumentStatus::ACTUAL;
+        });
+}
+
+template <typename Traits>
+template <typename DocumentPredicate, typename ExecutionPolicy>
+Expected<std::vector<Document>> BasicSearchServer<Traits>::TryFindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                                                  DocumentPredicate document_predicate) const {
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    Query query(&arena);
+    if (const ParseError error = TryParseQuery(raw_query, true, query)) {
+        return error;
+    }
+    const auto top_documents = FindTopDocumentsIn(policy, &arena, query, document_predicate);
+    return std::vector<Document>(top_documents.begin(), top_documents.end());
+}
+
+template <typename Traits>
+template <typename DocumentPredicate>
+std::pmr::vector<Document> BasicSearchServer<Traits>::FindTopDocumentsWith(std::pmr::memory_resource* resource, std::string_view raw_query,
+                                                          DocumentPredicate document_predicate) const {
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    return FindTopDocumentsIn(std::execution::seq, resource, ParseQuery(raw_query, true, resource), document_predicate);
+}
+
+template <typename Traits>
+template <typename Result, typename DocumentPredicate, typename ExecutionPolicy>
+std::pmr::vector<Result> BasicSearchServer<Traits>::FindTopDocumentsIn(ExecutionPolicy&& policy, std::pmr::memory_resource* resource,
+                                                          const Query& query, DocumentPredicate document_predicate,
+                                                          QueryBudget* budget) const {
+    if constexpr (IS_AUTO_EXECUTION_POLICY<ExecutionPolicy>) {
+        return PreferParallelQuery(query)
+            ? FindTopDocumentsIn<Result>(std::execution::par, resource, query, document_predicate, budget)
+            : FindTopDocumentsIn<Result>(std::execution::seq, resource, query, document_predicate, budget);
+    } else {
+        const PlannedQuery plan = PlanQuery(query, resource, budget != nullptr);
+        if (plan.tries_champion_lists) {
+            bool is_complete = false;
+            auto top_documents = FindTopByChampions<Result>(plan, document_predicate, Traits::max_result_document_count,
+                                                            options_.champion_list_size, resource, is_complete);
+            if (top_documents && is_complete) {
+                return std::move(*top_documents);
+            }
+        }
+        auto matched_documents = FindAllDocuments<Result>(policy, plan, document_predicate, resource, budget);
+        OrderByRank(policy, matched_documents, Traits::max_result_document_count, Traits::relevance_epsilon);
+        return matched_documents;
+    }
+}
+
+template <typename Traits>
+template <typename DocumentPredicate, typename ExecutionPolicy>
+SearchPage BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query,
+                                          DocumentPredicate document_predicate, const PageRequest& page) const {
+    const AllocationProbe probe(HotPath::FIND_TOP_DOCUMENTS);
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto query = ParseQuery(raw_query, true, &arena);
+    if constexpr (IS_AUTO_EXECUTION_POLICY<ExecutionPolicy>) {
+        return PreferParallelQuery(query)
+            ? FindPageIn(std::execution::par, &arena, query, document_predicate, page)
+            : FindPageIn(std::execution::seq, &arena, query, document_predicate, page);
+    } else {
+        return FindPageIn(policy, &arena, query, document_predicate, page);
+    }
+}
+
+template <typename Traits>
+template <typename DocumentPredicate, typename ExecutionPolicy>
+SearchPage BasicSearchServer<Traits>::FindPageIn(ExecutionPolicy&& policy, std::pmr::memory_resource* resource,
+                                                 const Query& query, DocumentPredicate document_predicate,
+                                                 const PageRequest& page) const {
+    auto matched_documents = FindAllDocuments(policy, PlanQuery(query, resource, false), document_predicate, resource);
+    if (page.search_after) {
+        const Document last_seen(page.search_after->document_id, page.search_after->relevance, page.search_after->rating);
+        matched_documents.erase(std::remove_if(policy, matched_documents.begin(), matched_documents.end(),
+                                               [&last_seen](const Document& document) {
+                                                   return !IsRankedBeforeWithin(last_seen, document, Traits::relevance_epsilon);
+                                               }),
+                                matched_documents.end());
+    }
+    
+    const size_t matched_count = matched_documents.size();
+    const size_t page_begin = std::min(page.offset, matched_count);
+    const size_t page_end = page_begin + std::min(page.limit, matched_count - page_begin);
+    OrderByRank(policy, matched_documents, page_end, Traits::relevance_epsilon);
+    
+    SearchPage result;
+    result.documents.assign(matched_documents.begin() + page_begin, matched_documents.begin() + page_end);
+    if (page_end < matched_count && page_end > 0) {
+        const Document& last = matched_documents[page_end - 1];
+        result.next_cursor = SearchCursor{last.id, last.relevance, last.rating};
+    }
+    return result;
+}
+
+template <typename Traits>
+template <typename ExecutionPolicy>
+SearchPage BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, const PageRequest& page) const
+{
+    return FindTopDocuments(policy, raw_query, [](int, DocumentStatus document_status, int) {
+            return document_status == DocumentStatus::ACTUAL;
+        }, page);
 }
 
+template <typename Traits>
 template <typename ExecutionPolicy>
-std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, DocumentStatus status) const
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query, DocumentStatus status) const
 {
     return FindTopDocuments(policy, raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
             return document_status == status;
         });
 }
 
+template <typename Traits>
 template <typename ExecutionPolicy>
-std::vector<Document> SearchServer::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query) const
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(ExecutionPolicy&& policy, std::string_view raw_query) const
 {
     return FindTopDocuments(policy, raw_query, DocumentStatus::ACTUAL);
 }
 
+template <typename Traits>
+int BasicSearchServer<Traits>::GetDocumentCount() const {
+    return documents_.size();
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::IsStopWord(std::string_view word) const {
+    return stop_words_.count(word) > 0;
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::IsQueryStopWord(std::string_view word) const {
+    if (options_.max_query_document_ratio >= 1.0) {
+        return false;
+    }
+    const auto* postings = FindPostings(word);
+    return postings != nullptr && postings->size() > options_.max_query_document_ratio * documents_.size();
+}
+
+template <typename Traits>
+TermStatistics BasicSearchServer<Traits>::MakeTermStatistics(int term_id) const {
+    return {std::string(dictionary_.GetWord(term_id)), term_to_document_freqs_[term_id].size(),
+            static_cast<double>(ComputeWordInverseDocumentFreq(term_id))};
+}
+
+template <typename Traits>
+template <typename TermFilter>
+std::vector<TermStatistics> BasicSearchServer<Traits>::CollectTermStatistics(TermFilter term_filter) const {
+    std::vector<TermStatistics> statistics;
+    for (int term_id = 0; term_id < static_cast<int>(term_to_document_freqs_.size()); ++term_id) {
+        if (dictionary_.IsLive(term_id) && !term_to_document_freqs_[term_id].empty()
+            && term_filter(term_to_document_freqs_[term_id].size())) {
+            statistics.push_back(MakeTermStatistics(term_id));
+        }
+    }
+    std::sort(statistics.begin(), statistics.end(), [](const TermStatistics& lhs, const TermStatistics& rhs) {
+        return lhs.document_freq != rhs.document_freq ? lhs.document_freq > rhs.document_freq : lhs.word < rhs.word;
+    });
+    return statistics;
+}
+
+template <typename Traits>
+TermStatistics BasicSearchServer<Traits>::GetTermStatistics(std::string_view word) const {
+    const int term_id = dictionary_.Find(word);
+    if (term_id == TermDictionary::NO_TERM) {
+        return {std::string(word), 0, 0.0};
+    }
+    return MakeTermStatistics(term_id);
+}
+
+template <typename Traits>
+TermStatisticsSummary BasicSearchServer<Traits>::GetTermStatisticsSummary() const {
+    TermStatisticsSummary summary;
+    summary.document_count = documents_.size();
+    for (int term_id = 0; term_id < static_cast<int>(term_to_document_freqs_.size()); ++term_id) {
+        const size_t document_freq = term_to_document_freqs_[term_id].size();
+        if (!dictionary_.IsLive(term_id) || document_freq == 0) {
+            continue;
+        }
+        ++summary.term_count;
+        summary.posting_count += document_freq;
+        size_t bucket = 0;
+        while ((size_t{2} << bucket) <= document_freq) {
+            ++bucket;
+        }
+        if (summary.buckets.size() <= bucket) {
+            summary.buckets.resize(bucket + 1);
+        }
+        ++summary.buckets[bucket].term_count;
+        summary.buckets[bucket].posting_count += document_freq;
+    }
+    for (size_t bucket = 0; bucket < summary.buckets.size(); ++bucket) {
+        summary.buckets[bucket].min_document_freq = size_t{1} << bucket;
+        summary.buckets[bucket].max_document_freq = (size_t{2} << bucket) - 1;
+    }
+    summary.buckets.erase(std::remove_if(summary.buckets.begin(), summary.buckets.end(),
+                                         [](const DocumentFreqBucket& bucket) {
+                                             return bucket.term_count == 0;
+                                         }),
+                          summary.buckets.end());
+    return summary;
+}
+
+template <typename Traits>
+std::vector<TermStatistics> BasicSearchServer<Traits>::GetMostFrequentTerms(size_t count) const {
+    std::vector<TermStatistics> statistics = CollectTermStatistics([](size_t) {
+        return true;
+    });
+    statistics.resize(std::min(count, statistics.size()));
+    return statistics;
+}
+
+template <typename Traits>
+std::vector<TermStatistics> BasicSearchServer<Traits>::SuggestStopWords(double min_document_ratio) const {
+    const double min_document_freq = min_document_ratio * documents_.size();
+    return CollectTermStatistics([min_document_freq](size_t document_freq) {
+        return document_freq > min_document_freq;
+    });
+}
+
+template <typename Traits>
+ParseError BasicSearchServer<Traits>::TrySplitIntoWordsNoStop(std::string_view text, std::vector<std::string>& words) const {
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    for (const std::string_view word : SplitIntoWords(text, &arena)) {
+        const auto invalid_char = std::find_if(word.begin(), word.end(), [](char c) {
+            return c >= '\0' && c < ' ';
+        });
+        if (invalid_char != word.end()) {
+            return {ParseErrorCode::INVALID_CHARACTER,
+                    static_cast<size_t>(word.data() - text.data()) + (invalid_char - word.begin()), word};
+        }
+        if (!IsStopWord(word)) {
+            words.push_back(CopyString(word));
+        }
+    }
+    return {};
+}
+
+template <typename Traits>
+std::vector<std::string> BasicSearchServer<Traits>::SplitIntoWordsNoStop(std::string_view text) const {
+    std::vector<std::string> words;
+    if (const ParseError error = TrySplitIntoWordsNoStop(text, words)) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Word "s + std::string(error.word) + " is invalid"s);
+    }
+    return words;
+}
+
+template <typename Traits>
+ParseError BasicSearchServer<Traits>::ParseQueryWord(std::string_view text, size_t position, QueryWord& query_word) const {
+    if (text.empty()) {
+        return {ParseErrorCode::EMPTY_WORD, position, text};
+    }
+    std::string_view word = text;
+    bool is_minus = false;
+    if (word[0] == '-') {
+        is_minus = true;
+        word.remove_prefix(1);
+    }
+    if (word.empty()) {
+        return {ParseErrorCode::EMPTY_WORD, position, text};
+    }
+    if (word[0] == '-') {
+        return {ParseErrorCode::DOUBLE_MINUS, position, text};
+    }
+    const auto invalid_char = std::find_if(word.begin(), word.end(), [](char c) {
+        return c >= '\0' && c < ' ';
+    });
+    if (invalid_char != word.end()) {
+        return {ParseErrorCode::INVALID_CHARACTER,
+                position + (is_minus ? 1 : 0) + (invalid_char - word.begin()), text};
+    }
+    // minus words are always applied, excluding a frequent word still narrows the results
+    query_word = {word, is_minus, IsStopWord(word) || (!is_minus && IsQueryStopWord(word))};
+    return {};
+}
+
+template <typename Traits>
+ParseError BasicSearchServer<Traits>::TryParseQuery(std::string_view text, bool is_parallel, Query& result) const {
+    for (const std::string_view word : SplitIntoWords(text, result.plus_words.get_allocator().resource())) {
+        QueryWord query_word;
+        if (const ParseError error = ParseQueryWord(word, word.data() - text.data(), query_word)) {
+            return error;
+        }
+        if (!query_word.is_stop) {
+            if (query_word.is_minus) {
+                result.minus_words.push_back(query_word.data);
+            } else {
+                result.plus_words.push_back(query_word.data);
+            }
+        }
+    }
+    if(is_parallel)
+    {
+        std::sort(result.plus_words.begin(), result.plus_words.end());
+        std::sort(result.minus_words.begin(), result.minus_words.end());
+        result.plus_words.erase(std::unique(result.plus_words.begin(), result.plus_words.end()), result.plus_words.end());
+        result.minus_words.erase(std::unique(result.minus_words.begin(), result.minus_words.end()), result.minus_words.end());
+    }
+    return {};
+}
+
+template <typename Traits>
+typename BasicSearchServer<Traits>::Query BasicSearchServer<Traits>::ParseQuery(std::string_view text, bool is_parallel,
+                                             std::pmr::memory_resource* resource) const {
+    BasicSearchServer<Traits>::Query result(resource);
+    if (const ParseError error = TryParseQuery(text, is_parallel, result)) {
+        using namespace std::string_literals;
+        if (error.code == ParseErrorCode::EMPTY_WORD && error.word.empty()) {
+            throw std::invalid_argument("Query word is empty"s);
+        }
+        throw std::invalid_argument("Query word "s + std::string(error.word) + " is invalid");
+    }
+    return result;
+}
+
+template <typename Traits>
+ParseError BasicSearchServer<Traits>::CheckQuery(std::string_view raw_query) const {
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    Query query(&arena);
+    return TryParseQuery(raw_query, false, query);
+}
+
+template <typename Traits>
+typename BasicSearchServer<Traits>::Score BasicSearchServer<Traits>::ComputeWordInverseDocumentFreq(int term_id) const {
+    const auto& postings = term_to_document_freqs_[term_id];
+    if (postings.empty()) {
+        return Score{};
+    }
+    return Scorer::template InverseDocumentFreq<Score>(documents_.size(), postings.size());
+}
+
+template <typename Traits>
+typename BasicSearchServer<Traits>::PlannedQuery
+BasicSearchServer<Traits>::PlanQuery(const Query& query, std::pmr::memory_resource* resource, bool is_budgeted) const {
+    PlannedQuery plan(resource);
+    for (const std::string_view word : query.minus_words) {
+        const int term_id = dictionary_.Find(word);
+        if (term_id != TermDictionary::NO_TERM && !term_to_document_freqs_[term_id].empty()) {
+            plan.minus_terms.push_back(term_id);
+            plan.minus_postings += term_to_document_freqs_[term_id].size();
+        }
+    }
+    for (const std::string_view word : query.plus_words) {
+        const int term_id = dictionary_.Find(word);
+        if (term_id == TermDictionary::NO_TERM || term_to_document_freqs_[term_id].empty()) {
+            continue;
+        }
+        if (ComputeWordInverseDocumentFreq(term_id) <= options_.negligible_inverse_document_freq) {
+            plan.pruned_terms.push_back(term_id);
+        } else {
+            plan.plus_terms.push_back(term_id);
+            plan.plus_postings += term_to_document_freqs_[term_id].size();
+        }
+    }
+    // short lists carry the highest IDF, a deadline hitting later terms loses the least relevance
+    std::sort(plan.plus_terms.begin(), plan.plus_terms.end(), [this](int lhs, int rhs) {
+        const size_t lhs_size = term_to_document_freqs_[lhs].size();
+        const size_t rhs_size = term_to_document_freqs_[rhs].size();
+        return lhs_size != rhs_size ? lhs_size < rhs_size : lhs < rhs;
+    });
+    
+    plan.term_at_a_time_cost = EstimateTermAtATimeCost(plan.plus_postings, documents_.size());
+    plan.document_at_a_time_cost = EstimateDocumentAtATimeCost(plan.plus_postings, plan.plus_terms.size(),
+                                                               documents_.size());
+    if (!is_budgeted && plan.document_at_a_time_cost < plan.term_at_a_time_cost) {
+        plan.strategy = ScoringStrategy::DOCUMENT_AT_A_TIME;
+    }
+    
+    size_t champion_candidates = 0;
+    for (const int term_id : plan.plus_terms) {
+        const auto champions = term_to_champions_.find(term_id);
+        plan.has_champion_lists = plan.has_champion_lists || champions != term_to_champions_.end();
+        champion_candidates += champions != term_to_champions_.end()
+            ? std::min(champions->second.postings.size(), options_.champion_list_size)
+            : term_to_document_freqs_[term_id].size();
+    }
+    if (plan.has_champion_lists) {
+        plan.champion_lists_cost = EstimateChampionListsCost(champion_candidates, plan.plus_terms.size(),
+                                                             documents_.size());
+        plan.tries_champion_lists = !is_budgeted
+            && plan.champion_lists_cost < std::min(plan.term_at_a_time_cost, plan.document_at_a_time_cost);
+    }
+    return plan;
+}
+
+template <typename Traits>
+std::pmr::vector<typename BasicSearchServer<Traits>::DocumentId>
+BasicSearchServer<Traits>::CollectExcludedDocuments(const PlannedQuery& plan, std::pmr::memory_resource* resource) const {
+    std::pmr::vector<DocumentId> excluded_documents(resource);
+    excluded_documents.reserve(plan.minus_postings);
+    for (const int term_id : plan.minus_terms) {
+        for (const auto [document_id, _] : term_to_document_freqs_[term_id]) {
+            excluded_documents.push_back(document_id);
+        }
+    }
+    // a single posting list is already sorted
+    if (plan.minus_terms.size() > 1) {
+        std::sort(excluded_documents.begin(), excluded_documents.end());
+        excluded_documents.erase(std::unique(excluded_documents.begin(), excluded_documents.end()),
+                                 excluded_documents.end());
+    }
+    return excluded_documents;
+}
+
+template <typename Traits>
+PlannedTerm BasicSearchServer<Traits>::DescribeTerm(int term_id) const {
+    return {std::string(dictionary_.GetWord(term_id)), term_to_document_freqs_[term_id].size(),
+            static_cast<double>(ComputeWordInverseDocumentFreq(term_id))};
+}
+
+template <typename Traits>
+QueryPlan BasicSearchServer<Traits>::Explain(std::string_view raw_query) const {
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto query = ParseQuery(raw_query, true, &arena);
+    const PlannedQuery planned_query = PlanQuery(query, &arena, false);
+    
+    QueryPlan plan;
+    for (const int term_id : planned_query.minus_terms) {
+        plan.minus_terms.push_back(DescribeTerm(term_id));
+    }
+    for (const int term_id : planned_query.plus_terms) {
+        plan.plus_terms.push_back(DescribeTerm(term_id));
+    }
+    for (const int term_id : planned_query.pruned_terms) {
+        plan.pruned_terms.push_back(DescribeTerm(term_id));
+    }
+    for (const std::string_view word : query.plus_words) {
+        const auto* postings = FindPostings(word);
+        if (postings == nullptr || postings->empty()) {
+            plan.pruned_terms.push_back({std::string(word), 0, 0.0});
+        }
+    }
+    plan.strategy = planned_query.strategy;
+    plan.tries_champion_lists = planned_query.tries_champion_lists;
+    plan.champion_lists_cost = planned_query.champion_lists_cost;
+    plan.estimated_postings = planned_query.minus_postings + planned_query.plus_postings;
+    plan.term_at_a_time_cost = planned_query.term_at_a_time_cost;
+    plan.document_at_a_time_cost = planned_query.document_at_a_time_cost;
+    return plan;
+}
+
+template <typename Traits>
+const std::map<typename BasicSearchServer<Traits>::DocumentId, typename BasicSearchServer<Traits>::Score>*
+BasicSearchServer<Traits>::FindPostings(std::string_view word) const {
+    const int term_id = dictionary_.Find(word);
+    return term_id == TermDictionary::NO_TERM ? nullptr : &term_to_document_freqs_[term_id];
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::IsValidWord(std::string_view word) {
+    return std::none_of(word.begin(), word.end(), [](char c) {
+        return c >= '\0' && c < ' ';
+    });
+}
+
+template <typename Traits>
+int BasicSearchServer<Traits>::ComputeAverageRating(const std::vector<int>& ratings) {
+    if (ratings.empty()) {
+        return 0;
+    }
+    int rating_sum = 0;
+    for (const int rating : ratings) {
+        rating_sum += rating;
+    }
+    return rating_sum / static_cast<int>(ratings.size());
+}
+
+template <typename Traits>
+typename BasicSearchServer<Traits>::DocumentIdIterator BasicSearchServer<Traits>::begin() const
+{
+    return document_ids_.begin();
+}
+
+template <typename Traits>
+typename BasicSearchServer<Traits>::DocumentIdIterator BasicSearchServer<Traits>::end() const
+{
+    return document_ids_.end();
+}
+
+template <typename Traits>
+IteratorRange<typename BasicSearchServer<Traits>::DocumentIdIterator> BasicSearchServer<Traits>::GetDocumentIdRange(int lo, int hi) const
+{
+    const auto first = std::lower_bound(document_ids_.begin(), document_ids_.end(), lo);
+    const auto last = std::lower_bound(first, document_ids_.end(), std::max(lo, hi));
+    return {first, last};
+}
+
+template <typename Traits>
+WordFrequenciesView BasicSearchServer<Traits>::GetWordFrequencies(int document_id) const
+{
+    if (!HasForwardIndex()) {
+        using namespace std::string_literals;
+        throw std::logic_error("Forward index is disabled"s);
+    }
+    if (!HasDocument(document_id)) {
+        return {};
+    }
+    if constexpr (Traits::forward_index) {
+        auto result=document_to_word_freqs_.find(document_id);
+        if(result!=document_to_word_freqs_.end())
+        {
+            const auto& term_frequencies = result->second;
+            return {term_frequencies.data(), term_frequencies.data() + term_frequencies.size(), dictionary_};
+        }
+    }
+    return {};
+}
+
+template <typename Traits>
+WordSetFingerprint BasicSearchServer<Traits>::GetWordSetFingerprint(int document_id) const
+{
+    const auto [first, last] = GetWordFrequencies(document_id).terms();
+    WordSetFingerprint fingerprint{0x9e3779b97f4a7c15ULL, 0xc2b2ae3d27d4eb4fULL};
+    for (auto it = first; it != last; ++it) {
+        const uint64_t term_id = static_cast<uint64_t>(it->term_id);
+        fingerprint.low = MixBits(fingerprint.low ^ term_id);
+        fingerprint.high = MixBits(fingerprint.high + term_id * 0xff51afd7ed558ccdULL);
+    }
+    fingerprint.low = MixBits(fingerprint.low ^ static_cast<uint64_t>(last - first));
+    fingerprint.high = MixBits(fingerprint.high ^ fingerprint.low);
+    return fingerprint;
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::AddDocument(int document_id, std::string_view document, DocumentStatus status, const std::vector<int>& ratings) {
+    const AllocationProbe probe(HotPath::ADD_DOCUMENT);
+    CheckNewDocumentId(document_id);
+    IndexDocument(static_cast<DocumentId>(document_id), SplitIntoWordsNoStop(document), status, ratings);
+    if (document_ids_.empty() || document_ids_.back() < document_id) {
+        document_ids_.push_back(document_id);
+    } else {
+        document_ids_.insert(std::lower_bound(document_ids_.begin(), document_ids_.end(), document_id), document_id);
+    }
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::AddDocuments(const std::vector<DocumentInput>& documents)
+{
+    AddDocuments(std::execution::seq, documents);
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::HasForwardIndex() const {
+    return Traits::forward_index && options_.keep_forward_index;
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::FitsDocumentId(int document_id) {
+    return document_id >= 0
+        && static_cast<long long>(document_id) <= static_cast<long long>(std::numeric_limits<DocumentId>::max());
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::HasDocument(int document_id) const {
+    return FitsDocumentId(document_id) && documents_.count(static_cast<DocumentId>(document_id)) > 0;
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::CheckNewDocumentId(int document_id) const {
+    if (!FitsDocumentId(document_id) || (documents_.count(static_cast<DocumentId>(document_id)) > 0)) {
+        using namespace std::string_literals;
+        throw std::invalid_argument("Invalid document_id"s);
+    }
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::IndexDocument(DocumentId document_id, const std::vector<std::string>& words,
+                                              DocumentStatus status, const std::vector<int>& ratings) {
+    const double inv_word_count = 1.0 / words.size();
+    std::vector<int> term_ids;
+    term_ids.reserve(words.size());
+    for (const std::string& word : words) {
+        term_ids.push_back(dictionary_.Intern(word));
+    }
+    std::sort(term_ids.begin(), term_ids.end());
+    if (!term_ids.empty() && term_ids.back() >= static_cast<int>(term_to_document_freqs_.size())) {
+        term_to_document_freqs_.resize(term_ids.back() + 1);
+    }
+    std::vector<TermFrequency> term_frequencies;
+    for (const int term_id : term_ids) {
+        if (term_frequencies.empty() || term_frequencies.back().term_id != term_id) {
+            term_frequencies.push_back({term_id, 0.0});
+        }
+        term_frequencies.back().frequency += inv_word_count;
+    }
+    for (const auto& [term_id, frequency] : term_frequencies) {
+        term_to_document_freqs_[term_id][document_id] = static_cast<Score>(frequency);
+    }
+    AddToChampionLists(document_id, term_frequencies);
+    if (near_duplicates_) {
+        near_duplicates_->AddDocument(document_id, WordFrequenciesView(term_frequencies.data(),
+            term_frequencies.data() + term_frequencies.size(), dictionary_));
+    }
+    if constexpr (Traits::forward_index) {
+        if (HasForwardIndex() && !term_frequencies.empty()) {
+            term_frequencies.shrink_to_fit();
+            document_to_word_freqs_.emplace(document_id, std::move(term_frequencies));
+        }
+    }
+    documents_.emplace(document_id, DocumentData{ComputeAverageRating(ratings), status});
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::EnableNearDuplicateDetection(size_t signature_size, size_t band_count)
+{
+    MinHashIndex index(signature_size, band_count);
+    if (HasForwardIndex()) {
+        for (const int document_id : document_ids_) {
+            index.AddDocument(document_id, GetWordFrequencies(document_id));
+        }
+        near_duplicates_ = std::move(index);
+        return;
+    }
+    // the term arrays are gathered from the postings instead, term ids ascending as in the forward index
+    std::map<DocumentId, std::vector<TermFrequency>> document_terms;
+    for (int term_id = 0; term_id < static_cast<int>(term_to_document_freqs_.size()); ++term_id) {
+        for (const auto& [document_id, term_freq] : term_to_document_freqs_[term_id]) {
+            document_terms[document_id].push_back({term_id, static_cast<double>(term_freq)});
+        }
+    }
+    for (const DocumentId document_id : document_ids_) {
+        const auto found = document_terms.find(document_id);
+        index.AddDocument(document_id, found == document_terms.end() ? WordFrequenciesView()
+            : WordFrequenciesView(found->second.data(), found->second.data() + found->second.size(), dictionary_));
+    }
+    near_duplicates_ = std::move(index);
+}
+
+template <typename Traits>
+const MinHashIndex& BasicSearchServer<Traits>::GetNearDuplicateIndex() const
+{
+    if (!near_duplicates_) {
+        using namespace std::string_literals;
+        throw std::logic_error("Near-duplicate detection is not enabled"s);
+    }
+    return *near_duplicates_;
+}
+
+template <typename Traits>
+std::vector<std::pair<int, double>> BasicSearchServer<Traits>::FindNearDuplicates(int document_id, double threshold) const
+{
+    if(!HasDocument(document_id))
+        throw std::out_of_range("Invalid document id");
+    return GetNearDuplicateIndex().FindNearDuplicates(document_id, threshold);
+}
+
+template <typename Traits>
+std::vector<std::vector<int>> BasicSearchServer<Traits>::ClusterNearDuplicates(double threshold) const
+{
+    return ClusterNearDuplicates(std::execution::seq, threshold);
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocument(int document_id)
+{
+    RemoveDocuments(std::execution::seq, {document_id});
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocument(std::execution::sequenced_policy policy, int document_id)
+{
+    RemoveDocument(document_id);
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocument(AutoExecutionPolicy policy, int document_id)
+{
+    RemoveDocuments(policy, {document_id});
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocuments(AutoExecutionPolicy, const std::vector<int>& document_ids)
+{
+    if (PreferParallelRemoval(document_ids)) {
+        RemoveDocuments(std::execution::par, document_ids);
+    } else {
+        RemoveDocuments(std::execution::seq, document_ids);
+    }
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::PreferParallelQuery(const Query& query) const
+{
+    if (query.plus_words.size() < 2 || !HasParallelHardware()) {
+        return false;
+    }
+    size_t posting_count = 0;
+    for (const auto* words : {&query.plus_words, &query.minus_words}) {
+        for (const std::string_view word : *words) {
+            if (const auto* postings = FindPostings(word)) {
+                posting_count += postings->size();
+            }
+        }
+    }
+    return posting_count >= options_.execution_thresholds.query_postings;
+}
+
+template <typename Traits>
+bool BasicSearchServer<Traits>::PreferParallelRemoval(const std::vector<int>& document_ids) const
+{
+    if (!HasParallelHardware()) {
+        return false;
+    }
+    if (!HasForwardIndex()) {
+        return term_to_document_freqs_.size() >= options_.execution_thresholds.removal_postings;
+    }
+    size_t posting_count = 0;
+    for (const int document_id : document_ids) {
+        posting_count += GetWordFrequencies(document_id).size();
+    }
+    return posting_count >= options_.execution_thresholds.removal_postings;
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocument(std::execution::parallel_policy, int document_id)
+{
+    RemoveDocuments(std::execution::par, {document_id});
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveDocuments(const std::vector<int>& document_ids)
+{
+    RemoveDocuments(std::execution::seq, document_ids);
+}
+
+template <typename Traits>
+size_t BasicSearchServer<Traits>::GetChampionListCapacity(size_t posting_count) const
+{
+    return options_.champion_list_size
+        + std::max(options_.champion_list_size, posting_count / options_.champion_list_size);
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::BuildChampionList(int term_id)
+{
+    const auto& postings = term_to_document_freqs_[term_id];
+    ChampionList& champions = term_to_champions_[term_id];
+    champions.postings.clear();
+    champions.postings.reserve(postings.size());
+    for (const auto [document_id, term_freq] : postings) {
+        champions.postings.push_back({document_id, term_freq});
+    }
+    const auto is_heavier = [](const ChampionPosting& lhs, const ChampionPosting& rhs) {
+        return lhs.term_freq != rhs.term_freq ? lhs.term_freq > rhs.term_freq : lhs.document_id < rhs.document_id;
+    };
+    const size_t size = std::min(GetChampionListCapacity(postings.size()), champions.postings.size());
+    std::nth_element(champions.postings.begin(), champions.postings.begin() + size, champions.postings.end(), is_heavier);
+    champions.outside_bound = Score{};
+    for (auto it = champions.postings.begin() + size; it != champions.postings.end(); ++it) {
+        champions.outside_bound = std::max(champions.outside_bound, it->term_freq);
+    }
+    champions.postings.resize(size);
+    champions.postings.shrink_to_fit();
+    std::sort(champions.postings.begin(), champions.postings.end(), is_heavier);
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::AddToChampionLists(DocumentId document_id, const std::vector<TermFrequency>& term_frequencies)
+{
+    if (options_.champion_list_size == 0) {
+        return;
+    }
+    for (const auto& [term_id, frequency] : term_frequencies) {
+        const auto found = term_to_champions_.find(term_id);
+        if (found == term_to_champions_.end()) {
+            if (term_to_document_freqs_[term_id].size() >= options_.champion_list_min_postings) {
+                BuildChampionList(term_id);
+            }
+            continue;
+        }
+        ChampionList& champions = found->second;
+        const ChampionPosting posting{document_id, static_cast<Score>(frequency)};
+        const auto position = std::upper_bound(champions.postings.begin(), champions.postings.end(), posting,
+                                               [](const ChampionPosting& lhs, const ChampionPosting& rhs) {
+                                                   return lhs.term_freq != rhs.term_freq
+                                                       ? lhs.term_freq > rhs.term_freq : lhs.document_id < rhs.document_id;
+                                               });
+        if (champions.postings.size() < GetChampionListCapacity(term_to_document_freqs_[term_id].size())) {
+            champions.postings.insert(position, posting);
+        } else if (position != champions.postings.end()) {
+            champions.outside_bound = std::max(champions.outside_bound, champions.postings.back().term_freq);
+            champions.postings.pop_back();
+            champions.postings.insert(position, posting);
+        } else {
+            champions.outside_bound = std::max(champions.outside_bound, posting.term_freq);
+        }
+    }
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::RemoveFromChampionLists(const std::vector<int>& term_ids,
+                                                        const std::vector<DocumentId>& victims)
+{
+    for (const int term_id : term_ids) {
+        const auto found = term_to_champions_.find(term_id);
+        if (found == term_to_champions_.end()) {
+            continue;
+        }
+        const auto& postings = term_to_document_freqs_[term_id];
+        if (postings.empty()) {
+            term_to_champions_.erase(found);
+            continue;
+        }
+        auto& champions = found->second.postings;
+        champions.erase(std::remove_if(champions.begin(), champions.end(), [&victims](const ChampionPosting& posting) {
+                            return std::binary_search(victims.begin(), victims.end(), posting.document_id);
+                        }),
+                        champions.end());
+        // the bound still holds, the list is refilled once the reserve can't cover what queries read
+        if (champions.size() < options_.champion_list_size && postings.size() > champions.size()) {
+            BuildChampionList(term_id);
+        }
+    }
+}
+
+template <typename Traits>
+void BasicSearchServer<Traits>::CompactDictionary()
+{
+    const std::vector<int> remap = dictionary_.Compact();
+    std::vector<std::map<DocumentId, Score>> compacted(dictionary_.GetTermCount());
+    for (size_t old_id = 0; old_id < remap.size(); ++old_id) {
+        if (remap[old_id] != TermDictionary::NO_TERM) {
+            compacted[remap[old_id]] = std::move(term_to_document_freqs_[old_id]);
+        }
+    }
+    term_to_document_freqs_ = std::move(compacted);
+    std::map<int, ChampionList> compacted_champions;
+    for (auto& [old_id, champions] : term_to_champions_) {
+        if (remap[old_id] != TermDictionary::NO_TERM) {
+            compacted_champions.emplace(remap[old_id], std::move(champions));
+        }
+    }
+    term_to_champions_ = std::move(compacted_champions);
+    // the remapping keeps the relative order of term ids, so the arrays stay sorted
+    if constexpr (Traits::forward_index) {
+        for (auto& [_, term_frequencies] : document_to_word_freqs_) {
+            for (auto& item : term_frequencies) {
+                item.term_id = remap[item.term_id];
+            }
+        }
+    }
+}
+
+template <typename Traits>
+size_t BasicSearchServer<Traits>::GetTermCount() const
+{
+    return dictionary_.GetTermCount();
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchDocument(std::string_view raw_query, int document_id) const {
+    const AllocationProbe probe(HotPath::MATCH_DOCUMENT);
+    if(!HasDocument(document_id))
+        throw std::out_of_range("Invalid document id");
+    
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    return MatchParsedQuery(ParseQuery(raw_query, true, &arena), document_id);
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchDocument(std::string_view raw_query, int document_id,
+                                                           const StopToken& stop_token) const {
+    stop_token.ThrowIfStopRequested();
+    const AllocationProbe probe(HotPath::MATCH_DOCUMENT);
+    if(!HasDocument(document_id))
+        throw std::out_of_range("Invalid document id");
+    
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto query = ParseQuery(raw_query, true, &arena);
+    stop_token.ThrowIfStopRequested();
+    auto result = MatchParsedQuery(query, document_id);
+    stop_token.ThrowIfStopRequested();
+    return result;
+}
+
+template <typename Traits>
+Expected<matched_documents> BasicSearchServer<Traits>::TryMatchDocument(std::string_view raw_query, int document_id) const {
+    const AllocationProbe probe(HotPath::MATCH_DOCUMENT);
+    if(!HasDocument(document_id))
+        return ParseError{ParseErrorCode::INVALID_DOCUMENT_ID, 0, {}};
+    
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    Query query(&arena);
+    if (const ParseError error = TryParseQuery(raw_query, true, query)) {
+        return error;
+    }
+    return MatchParsedQuery(query, document_id);
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchParsedQuery(const Query& query, int document_id) const {
+    std::vector<std::string_view> matched_words;
+    
+    for (const std::string_view word : query.minus_words) {
+        const auto* postings = FindPostings(word);
+        if (postings!=nullptr&&postings->count(document_id)) {
+            return {matched_words, documents_.at(document_id).status};
+        }
+    }
+    
+    for (const std::string_view word : query.plus_words) {
+        const int term_id = dictionary_.Find(word);
+        if (term_id!=TermDictionary::NO_TERM&&term_to_document_freqs_[term_id].count(document_id)) {
+            matched_words.push_back(dictionary_.GetWord(term_id));
+        }
+    }
+    
+    return {matched_words, documents_.at(document_id).status};
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchDocument(std::execution::sequenced_policy policy, std::string_view raw_query,
+                                                        int document_id) const
+{
+    return MatchDocument(raw_query, document_id);
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchDocument(AutoExecutionPolicy, std::string_view raw_query,
+                                                           int document_id) const
+{
+    const AllocationProbe probe(HotPath::MATCH_DOCUMENT);
+    if(!HasDocument(document_id))
+        throw std::out_of_range("Invalid document id");
+    
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    const auto query = ParseQuery(raw_query, true, &arena);
+    if (HasParallelHardware()
+        && query.plus_words.size() + query.minus_words.size() >= options_.execution_thresholds.match_words) {
+        return MatchParsedQuery(std::execution::par, query, document_id);
+    }
+    return MatchParsedQuery(query, document_id);
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchDocument(std::execution::parallel_policy, std::string_view raw_query,
+                                                        int document_id) const
+{
+    const AllocationProbe probe(HotPath::MATCH_DOCUMENT);
+    if(!HasDocument(document_id))
+        throw std::out_of_range("Invalid document id");
+    
+    ArenaResource& arena = GetThreadQueryArena();
+    ArenaResource::Scope scope(arena);
+    return MatchParsedQuery(std::execution::par, ParseQuery(raw_query, false, &arena), document_id);
+}
+
+template <typename Traits>
+matched_documents BasicSearchServer<Traits>::MatchParsedQuery(std::execution::parallel_policy, const Query& query,
+                                                              int document_id) const
+{
+    std::vector<std::string_view> matched_words;
+
+    auto ans = std::find_if(std::execution::par, query.minus_words.begin(), query.minus_words.end(), [&](const auto& it){const auto* postings = FindPostings(it); return postings!=nullptr&&postings->count(document_id) ? true : false;});
+    
+    if(ans!=query.minus_words.end())
+    {
+        return {matched_words, documents_.at(document_id).status};
+    }
+    else
+    {
+        matched_words.resize(query.plus_words.size());
+        std::transform(std::execution::par, query.plus_words.begin(), query.plus_words.end(), matched_words.begin(), [&](const auto& it){const int term_id = dictionary_.Find(it); return term_id!=TermDictionary::NO_TERM&&term_to_document_freqs_[term_id].count(document_id)?dictionary_.GetWord(term_id):std::string_view();});
+        matched_words.erase(std::remove(matched_words.begin(), matched_words.end(), std::string_view()), matched_words.end());
+        std::sort(matched_words.begin(), matched_words.end());
+        matched_words.erase(std::unique(matched_words.begin(), matched_words.end()), matched_words.end());
+        return {matched_words, documents_.at(document_id).status};
+    }
+}
+
+template <typename Traits>
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(std::string_view raw_query, DocumentStatus status) const {
+    return FindTopDocuments(std::execution::seq, raw_query, [status](int document_id, DocumentStatus document_status, int rating) {
+            return document_status == status;
+        });
+}
+
+template <typename Traits>
+std::vector<Document> BasicSearchServer<Traits>::FindTopDocuments(std::string_view raw_query) const
+{
+    return FindTopDocuments(raw_query, DocumentStatus::ACTUAL);
+}
+
+template <typename Traits>
+SearchPage BasicSearchServer<Traits>::FindTopDocuments(std::string_view raw_query, const PageRequest& page) const
+{
+    return FindTopDocuments(std::execution::seq, raw_query, page);
+}
+
+template <typename Traits>
+std::pmr::vector<Document> BasicSearchServer<Traits>::FindTopDocumentsWith(std::pmr::memory_resource* resource, std::string_view raw_query) const
+{
+    return FindTopDocumentsWith(resource, raw_query, [](int, DocumentStatus document_status, int) {
+            return document_status == DocumentStatus::ACTUAL;
+        });
+}
+
+template <typename Traits>
+SearchResult BasicSearchServer<Traits>::FindTopDocuments(std::string_view raw_query, const QueryOptions& options) const
+{
+    return FindTopDocuments(std::execution::seq, raw_query, options);
+}
+
+template <typename Traits>
+std::vector<CompactDocument> BasicSearchServer<Traits>::FindTopCompactDocuments(std::string_view raw_query) const
+{
+    return FindTopCompactDocuments(std::execution::seq, raw_query);
+}
+
+template <typename Traits>
+Expected<std::vector<Document>> BasicSearchServer<Traits>::TryFindTopDocuments(std::string_view raw_query, DocumentStatus status) const
+{
+    return TryFindTopDocuments(std::execution::seq, raw_query, [status](int, DocumentStatus document_status, int) {
+            return document_status == status;
+        });
+}
+
+using SearchServer = BasicSearchServer<SearchServerTraits>;
+extern template class BasicSearchServer<SearchServerTraits>;
+
 void AddDocument(SearchServer& search_server, int document_id, const std::string& document,
                  DocumentStatus status, const std::vector<int>& ratings);
 void FindTopDocuments(const SearchServer& search_server, const std::string& raw_query);
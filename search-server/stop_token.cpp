@@ -0,0 +1,44 @@
+#include "stop_token.h"
+
+using namespace std;
+
+OperationCancelled::OperationCancelled()
+    : runtime_error("Operation cancelled"s)
+{
+}
+
+StopToken::StopToken(shared_ptr<const atomic<bool>> state)
+    : state_(move(state))
+{
+}
+
+bool StopToken::StopRequested() const {
+    return state_ && state_->load(memory_order_relaxed);
+}
+
+bool StopToken::StopPossible() const {
+    return state_ != nullptr;
+}
+
+void StopToken::ThrowIfStopRequested() const {
+    if (StopRequested()) {
+        throw OperationCancelled();
+    }
+}
+
+StopSource::StopSource()
+    : state_(make_shared<atomic<bool>>(false))
+{
+}
+
+StopToken StopSource::GetToken() const {
+    return StopToken(state_);
+}
+
+bool StopSource::RequestStop() {
+    return !state_->exchange(true, memory_order_relaxed);
+}
+
+bool StopSource::StopRequested() const {
+    return state_->load(memory_order_relaxed);
+}
\ No newline at end of file
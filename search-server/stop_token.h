@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
+// Thrown by operations that stopped because their token was triggered
+class OperationCancelled : public std::runtime_error {
+public:
+    OperationCancelled();
+};
+
+// C++17 stand-in for std::stop_token: a cheap copyable view of a StopSource's flag.
+// A default-constructed token never requests a stop.
+class StopToken {
+public:
+    StopToken() = default;
+    
+    bool StopRequested() const;
+    bool StopPossible() const;
+    void ThrowIfStopRequested() const;
+private:
+    friend class StopSource;
+    explicit StopToken(std::shared_ptr<const std::atomic<bool>> state);
+    
+    std::shared_ptr<const std::atomic<bool>> state_;
+};
+
+class StopSource {
+public:
+    StopSource();
+    
+    StopToken GetToken() const;
+    // Returns false if the stop was already requested
+    bool RequestStop();
+    bool StopRequested() const;
+private:
+    std::shared_ptr<std::atomic<bool>> state_;
+};
\ No newline at end of file
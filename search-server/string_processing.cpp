@@ -1,4 +1,5 @@
 #include "string_processing.h"
+#include <algorithm>
 
 using namespace std;
 
@@ -8,7 +9,7 @@ vector<string> SplitIntoWords(const string& text) {
     for (const char c : text) {
         if (c == ' ') {
             if (!word.empty()) {
-                words.push_back(word);
+                words.push_back(move(word));
                 word.clear();
             }
         } else {
@@ -16,7 +17,22 @@ vector<string> SplitIntoWords(const string& text) {
         }
     }
     if (!word.empty()) {
-        words.push_back(word);
+        words.push_back(move(word));
+    }
+    return words;
+}
+
+pmr::vector<string_view> SplitIntoWords(string_view text, pmr::memory_resource* resource) {
+    pmr::vector<string_view> words(resource);
+    while (!text.empty()) {
+        const size_t word_begin = text.find_first_not_of(' ');
+        if (word_begin == string_view::npos) {
+            break;
+        }
+        text.remove_prefix(word_begin);
+        const size_t word_end = min(text.find(' '), text.size());
+        words.push_back(text.substr(0, word_end));
+        text.remove_prefix(word_end);
     }
     return words;
 }
\ No newline at end of file
@@ -2,15 +2,20 @@
 #include <set>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory_resource>
 
 std::vector<std::string> SplitIntoWords(const std::string& text);
 
+// Views into text, the vector is allocated from resource
+std::pmr::vector<std::string_view> SplitIntoWords(std::string_view text, std::pmr::memory_resource* resource);
+
 template <typename StringContainer>
-std::set<std::string> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
-    std::set<std::string> non_empty_strings;
+std::set<std::string, std::less<>> MakeUniqueNonEmptyStrings(const StringContainer& strings) {
+    std::set<std::string, std::less<>> non_empty_strings;
     for (const auto& str : strings) {
         if (!str.empty()) {
-            non_empty_strings.insert(str);
+            non_empty_strings.insert(std::string(str));
         }
     }
     return non_empty_strings;
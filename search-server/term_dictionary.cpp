@@ -0,0 +1,61 @@
+#include "term_dictionary.h"
+#include "alloc_stats.h"
+
+using namespace std;
+
+int TermDictionary::Intern(string_view word) {
+    const auto it = word_to_id_.find(word);
+    if (it != word_to_id_.end()) {
+        return it->second;
+    }
+    const int term_id = static_cast<int>(id_to_word_.size());
+    const auto& [stored_word, _] = *word_to_id_.emplace(CopyString(word), term_id).first;
+    id_to_word_.push_back(stored_word);
+    return term_id;
+}
+
+int TermDictionary::Find(string_view word) const {
+    const auto it = word_to_id_.find(word);
+    return it == word_to_id_.end() ? NO_TERM : it->second;
+}
+
+string_view TermDictionary::GetWord(int term_id) const {
+    return id_to_word_.at(term_id);
+}
+
+bool TermDictionary::IsLive(int term_id) const {
+    return term_id >= 0 && term_id < static_cast<int>(id_to_word_.size()) && !id_to_word_[term_id].empty();
+}
+
+void TermDictionary::Release(int term_id) {
+    if (!IsLive(term_id)) {
+        return;
+    }
+    word_to_id_.erase(word_to_id_.find(id_to_word_[term_id]));
+    id_to_word_[term_id] = {};
+}
+
+size_t TermDictionary::GetTermCount() const {
+    return word_to_id_.size();
+}
+
+size_t TermDictionary::GetCapacity() const {
+    return id_to_word_.size();
+}
+
+vector<int> TermDictionary::Compact() {
+    vector<int> remap(id_to_word_.size(), NO_TERM);
+    vector<string_view> compacted;
+    compacted.reserve(word_to_id_.size());
+    for (size_t old_id = 0; old_id < id_to_word_.size(); ++old_id) {
+        if (!id_to_word_[old_id].empty()) {
+            remap[old_id] = static_cast<int>(compacted.size());
+            compacted.push_back(id_to_word_[old_id]);
+        }
+    }
+    for (auto& [_, term_id] : word_to_id_) {
+        term_id = remap[term_id];
+    }
+    id_to_word_ = move(compacted);
+    return remap;
+}
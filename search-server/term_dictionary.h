@@ -0,0 +1,28 @@
+#pragma once
+#include <map>
+#include <string>
+#include <vector>
+#include <string_view>
+
+// Interns index terms and hands out dense integer ids.
+// Released ids leave holes until Compact() renumbers the live terms.
+// Views returned by GetWord stay valid until the term is released.
+class TermDictionary {
+public:
+    static constexpr int NO_TERM = -1;
+    
+    int Intern(std::string_view word);
+    int Find(std::string_view word) const;
+    std::string_view GetWord(int term_id) const;
+    bool IsLive(int term_id) const;
+    void Release(int term_id);
+    
+    size_t GetTermCount() const;
+    size_t GetCapacity() const;
+    
+    // Returns old id -> new id mapping, NO_TERM for released ids
+    std::vector<int> Compact();
+private:
+    std::map<std::string, int, std::less<>> word_to_id_;
+    std::vector<std::string_view> id_to_word_;
+};
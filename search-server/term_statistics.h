@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+struct TermStatistics {
+    std::string word;
+    // documents containing the word, which is also the length of its posting list
+    size_t document_freq = 0;
+    double inverse_document_freq = 0.0;
+};
+
+// Terms with document frequency in [min_document_freq, max_document_freq]
+struct DocumentFreqBucket {
+    size_t min_document_freq = 0;
+    size_t max_document_freq = 0;
+    size_t term_count = 0;
+    // postings of those terms, the scan cost of querying them all
+    size_t posting_count = 0;
+};
+
+struct TermStatisticsSummary {
+    size_t document_count = 0;
+    size_t term_count = 0;
+    size_t posting_count = 0;
+    // power-of-two document frequency ranges, ascending, empty ranges left out
+    std::vector<DocumentFreqBucket> buckets;
+};
\ No newline at end of file
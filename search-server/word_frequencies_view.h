@@ -0,0 +1,147 @@
+#pragma once
+#include "term_dictionary.h"
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+
+struct TermFrequency {
+    int term_id;
+    double frequency;
+};
+
+// Non-owning view over a document's (term_id, frequency) array sorted by term id.
+// Iteration yields (word, frequency) pairs, words are resolved through the dictionary
+// on dereference; use terms() to walk the raw array without touching the dictionary.
+class WordFrequenciesView {
+public:
+    class Iterator {
+    public:
+        // the full random access operator set, though dereferencing yields the pair by value
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = std::pair<std::string_view, double>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+        
+        Iterator() = default;
+        Iterator(const TermFrequency* current, const TermDictionary* dictionary)
+            : current_(current)
+            , dictionary_(dictionary) {
+        }
+        value_type operator*() const {
+            return {dictionary_->GetWord(current_->term_id), current_->frequency};
+        }
+        value_type operator[](difference_type n) const {
+            return *(*this + n);
+        }
+        Iterator& operator++() {
+            ++current_;
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator copy = *this;
+            ++current_;
+            return copy;
+        }
+        Iterator& operator--() {
+            --current_;
+            return *this;
+        }
+        Iterator operator--(int) {
+            Iterator copy = *this;
+            --current_;
+            return copy;
+        }
+        Iterator& operator+=(difference_type n) {
+            current_ += n;
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) {
+            current_ -= n;
+            return *this;
+        }
+        Iterator operator+(difference_type n) const {
+            return {current_ + n, dictionary_};
+        }
+        Iterator operator-(difference_type n) const {
+            return {current_ - n, dictionary_};
+        }
+        difference_type operator-(const Iterator& other) const {
+            return current_ - other.current_;
+        }
+        bool operator==(const Iterator& other) const {
+            return current_ == other.current_;
+        }
+        bool operator!=(const Iterator& other) const {
+            return current_ != other.current_;
+        }
+        bool operator<(const Iterator& other) const {
+            return current_ < other.current_;
+        }
+        bool operator>(const Iterator& other) const {
+            return current_ > other.current_;
+        }
+        bool operator<=(const Iterator& other) const {
+            return current_ <= other.current_;
+        }
+        bool operator>=(const Iterator& other) const {
+            return current_ >= other.current_;
+        }
+        friend Iterator operator+(difference_type n, const Iterator& it) {
+            return it + n;
+        }
+    private:
+        const TermFrequency* current_ = nullptr;
+        const TermDictionary* dictionary_ = nullptr;
+    };
+    
+    WordFrequenciesView() = default;
+    WordFrequenciesView(const TermFrequency* first, const TermFrequency* last, const TermDictionary& dictionary)
+        : first_(first)
+        , last_(last)
+        , dictionary_(&dictionary) {
+    }
+    
+    Iterator begin() const {
+        return {first_, dictionary_};
+    }
+    Iterator end() const {
+        return {last_, dictionary_};
+    }
+    size_t size() const {
+        return last_ - first_;
+    }
+    bool empty() const {
+        return first_ == last_;
+    }
+    
+    const TermFrequency* data() const {
+        return first_;
+    }
+    std::pair<const TermFrequency*, const TermFrequency*> terms() const {
+        return {first_, last_};
+    }
+    
+    // Binary search by term id, nullptr when the document doesn't contain the term
+    const TermFrequency* FindTerm(int term_id) const {
+        const TermFrequency* it = std::lower_bound(first_, last_, term_id,
+            [](const TermFrequency& item, int id) { return item.term_id < id; });
+        return it != last_ && it->term_id == term_id ? it : nullptr;
+    }
+    
+    size_t count(std::string_view word) const {
+        return dictionary_ != nullptr && FindTerm(dictionary_->Find(word)) != nullptr ? 1 : 0;
+    }
+    double at(std::string_view word) const {
+        const TermFrequency* item = dictionary_ != nullptr ? FindTerm(dictionary_->Find(word)) : nullptr;
+        if (item == nullptr) {
+            using namespace std::string_literals;
+            throw std::out_of_range("Word is not in the document"s);
+        }
+        return item->frequency;
+    }
+private:
+    const TermFrequency* first_ = nullptr;
+    const TermFrequency* last_ = nullptr;
+    const TermDictionary* dictionary_ = nullptr;
+};